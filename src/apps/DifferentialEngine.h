@@ -0,0 +1,117 @@
+#ifndef __SMARTSUBSTATION_DIFFERENTIALENGINE_H
+#define __SMARTSUBSTATION_DIFFERENTIALENGINE_H
+
+#include <cmath>
+#include <unordered_map>
+
+// DifferentialEngine：差动保护的样本对齐与判决逻辑，不依赖 OMNeT++/INET，
+// 由 DifferentialProtectionApp（仿真）与 SilProtectionApp（软件在环，真实 UDP）共用。
+//  - 严格模式：本地/远端样本按时隙 slot 缓存，同一 slot 两侧到齐后计算 |I_local - I_remote|，
+//    早于 (slot - maxSlotLag) 的缓存样本被清理；
+//  - 非严格模式：两侧最近一次有效电流值都存在时即比较；
+//  - 差值超过 threshold 判为动作（Trip）。
+class DifferentialEngine
+{
+  public:
+    struct Decision {
+        bool evaluated = false;    // 本样本是否完成了一次差动比较
+        bool trip = false;         // 差值是否超过阈值
+        bool missingSlot = false;  // 严格模式下样本缺少 slot 字段而被忽略
+        double diff = NAN;
+        long long slot = -1;
+    };
+
+  private:
+    double threshold = 0;
+    bool strictSlotMatch = true;
+    int maxSlotLag = 10;
+
+    // 最近一次接收到的电流值（NaN 表示尚未收到）
+    double lastLocal = NAN;
+    double lastRemote = NAN;
+    // 按时隙缓存样本值（slot -> 电流值），用于配对
+    std::unordered_map<long long, double> localSamples;
+    std::unordered_map<long long, double> remoteSamples;
+
+    long matchedCount = 0;
+    long overThresholdCount = 0;
+
+    static void pruneOldSamples(std::unordered_map<long long, double>& samples, long long minSlot) {
+        for (auto it = samples.begin(); it != samples.end(); ) {
+            if (it->first < minSlot)
+                it = samples.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    Decision judge(double diff, long long slot) {
+        Decision decision;
+        decision.evaluated = true;
+        decision.diff = diff;
+        decision.slot = slot;
+        matchedCount++;
+        if (diff > threshold) {
+            decision.trip = true;
+            overThresholdCount++;
+        }
+        return decision;
+    }
+
+  public:
+    void configure(double threshold, bool strictSlotMatch, int maxSlotLag) {
+        this->threshold = threshold;
+        this->strictSlotMatch = strictSlotMatch;
+        this->maxSlotLag = maxSlotLag;
+    }
+
+    double getThreshold() const { return threshold; }
+    long getMatchedCount() const { return matchedCount; }
+    long getOverThresholdCount() const { return overThresholdCount; }
+
+    // 处理一侧的一个样本；slot < 0 表示样本没有时隙标签
+    Decision process(bool fromLocal, double value, long long slot) {
+        if (fromLocal)
+            lastLocal = value;
+        else
+            lastRemote = value;
+        if (std::isnan(value))
+            return Decision();
+
+        if (strictSlotMatch) {
+            // 没有 slot 字段则不参与配对
+            if (slot < 0) {
+                Decision decision;
+                decision.missingSlot = true;
+                return decision;
+            }
+            if (fromLocal)
+                localSamples[slot] = value;
+            else
+                remoteSamples[slot] = value;
+
+            // 清理过旧的样本，避免缓存无限增长
+            if (maxSlotLag > 0) {
+                long long minSlot = slot - maxSlotLag;
+                pruneOldSamples(localSamples, minSlot);
+                pruneOldSamples(remoteSamples, minSlot);
+            }
+
+            auto itLocal = localSamples.find(slot);
+            auto itRemote = remoteSamples.find(slot);
+            if (itLocal == localSamples.end() || itRemote == remoteSamples.end())
+                return Decision();
+            Decision decision = judge(std::fabs(itLocal->second - itRemote->second), slot);
+            // 该 slot 已处理，移除缓存
+            localSamples.erase(slot);
+            remoteSamples.erase(slot);
+            return decision;
+        }
+
+        if (std::isnan(lastLocal) || std::isnan(lastRemote))
+            return Decision();
+        return judge(std::fabs(lastLocal - lastRemote), slot);
+    }
+};
+
+#endif
@@ -1,9 +1,12 @@
 #include <omnetpp.h>
+#include <chrono>
 #include <regex>
 #include <cmath>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "inet/common/INETDefs.h"
+#include "inet/common/ModuleAccess.h"
 #include "inet/common/packet/Packet.h"
 #include "inet/common/Units.h"
 #include "inet/common/packet/chunk/ByteCountChunk.h"
@@ -28,6 +31,9 @@ using namespace inet;
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "inet/common/InitStages.h"
 #include "inet/transportlayer/contract/udp/UdpSocket.h"
+#include "PrpDiscardTable.h"
+#include "SvSampleGenerator.h"
+#include "DifferentialEngine.h"
 
 using namespace omnetpp;
 using namespace inet;
@@ -58,6 +64,20 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
     int gooseDscp = 48;        // GOOSE 报文的 DSCP 值（CS6，次高优先级）
     bool recordStats = true;   // 是否记录端到端时延/抖动
 
+    // PRP 双网冗余：SV 按 (src, seq) 剔除 LAN A/B 重复帧；GOOSE 额外经 LAN B 发送
+    bool prpEnabled = false;
+    L3Address gooseLocalDestB;
+    L3Address gooseRemoteDestB;
+    int sourceId = -1;
+    long long gooseSeq = 0;
+    PrpDiscardTable prpTable;
+    long prpDuplicateCount = 0;
+    long prpOutOfWindowCount = 0;
+    long prpMalformedCount = 0;
+    // 重复剔除判定耗时（墙钟，仅 prpTable.check()）与进入剔除表的报文数，用于评估每包开销
+    double prpDiscardWallTime = 0;
+    long prpDiscardChecks = 0;
+
     // 端到端时延/抖动记录
     cOutVector delayLocalVec;
     cOutVector delayRemoteVec;
@@ -72,29 +92,33 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
     long localRxCount = 0;
     long remoteRxCount = 0;
 
-    // 差动比较计数与超阈值计数（按配对时隙/样本统计）
-    long matchedSvCount = 0;
-    long overThresholdCount = 0;
-
-    // 存储最近一次接收到的電流值（可能为 NaN 表示尚未收到）
-    double lastLocal = NAN;
-    double lastRemote = NAN;
-
     // 是否严格按时隙标签匹配：true 时只在“同一时隙 slot”成对后才计算差值
     bool strictSlotMatch = true;
-    int maxSlotLag = 10;
-
-    // 按时隙缓存样本值（slot -> 电流值），用于配对
-    std::unordered_map<long long, double> localSamples;
-    std::unordered_map<long long, double> remoteSamples;
 
-    void pruneOldSamples(std::unordered_map<long long, double> &samples, long long minSlot) {
-        for (auto it = samples.begin(); it != samples.end(); ) {
-            if (it->first < minSlot)
-                it = samples.erase(it);
-            else
-                ++it;
+    // 样本对齐与差动判决（与 SilProtectionApp 共用），内部维护配对计数与超阈值计数
+    DifferentialEngine engine;
+
+    // 构造并发送 GOOSE Trip 报文；PRP 开启时负载携带 src/seq，并经 LAN B 再发送一份
+    void sendGooseTrip() {
+        auto goosePkt = new Packet("GOOSE:TripCommand");
+        if (prpEnabled) {
+            std::string payload = "seq=" + std::to_string(gooseSeq++) + ";src=" + std::to_string(sourceId);
+            std::vector<uint8_t> payloadBytes(payload.begin(), payload.end());
+            goosePkt->insertAtBack(makeShared<BytesChunk>(payloadBytes));
+            int paddingBytes = 64 - static_cast<int>(payloadBytes.size());
+            if (paddingBytes > 0)
+                goosePkt->insertAtBack(makeShared<ByteCountChunk>(B(paddingBytes)));
+            socketGoose.sendTo(goosePkt->dup(), gooseLocalDestB, goosePort);
+            socketGoose.sendTo(goosePkt->dup(), gooseRemoteDestB, goosePort);
         }
+        else {
+            // 注意：这里用 ByteCountChunk(B(64)) 代表报文体占位，没有实现 GOOSE 格式细节
+            goosePkt->insertAtBack(makeShared<ByteCountChunk>(B(64)));
+        }
+        // DSCP 已通过 socket 的 IPv4 TOS 设置（在 initialize 阶段）
+        // 发送两份副本：到本地 IT 和远端 IT
+        socketGoose.sendTo(goosePkt->dup(), gooseLocalDest, goosePort);
+        socketGoose.sendTo(goosePkt, gooseRemoteDest, goosePort);
     }
 
   protected:
@@ -112,7 +136,12 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
             gooseDscp = par("gooseDscp");
             recordStats = par("recordStats");
             strictSlotMatch = par("strictSlotMatch");
-            maxSlotLag = par("maxSlotLag");
+            engine.configure(threshold, strictSlotMatch, par("maxSlotLag"));
+            prpEnabled = par("prpEnabled");
+            int windowSize = par("prpWindowSize");
+            if (windowSize <= 0)
+                throw cRuntimeError("prpWindowSize must be > 0");
+            prpTable.setWindowSize(windowSize);
 
             delayLocalVec.setName("svDelayLocal");
             delayRemoteVec.setName("svDelayRemote");
@@ -123,6 +152,11 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
             // 在应用层阶段解析地址（依赖于接口表），并初始化/绑定 UDP sockets
             gooseLocalDest = L3AddressResolver().resolve(par("gooseDestLocal"));
             gooseRemoteDest = L3AddressResolver().resolve(par("gooseDestRemote"));
+            if (prpEnabled) {
+                gooseLocalDestB = L3AddressResolver().resolve(par("gooseDestLocalB"));
+                gooseRemoteDestB = L3AddressResolver().resolve(par("gooseDestRemoteB"));
+                sourceId = getContainingNode(this)->getId();
+            }
 
             // 配置本地接收 socket：将输出门设置为模块的 socketOut，用回调处理收到的数据
             socketLocal.setOutputGate(gate("socketOut"));
@@ -171,17 +205,28 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
             payload.assign(bytes.begin(), bytes.end());
         }
 
-        std::smatch m;
-        double value = NAN;
-        if (std::regex_search(payload, m, std::regex("current=([+-]?[0-9]*\\.?[0-9]+)"))) {
-            value = std::stod(m[1].str());
-        }
-        // 从报文负载中解析时隙标签 slot（由 SV 发送端写入）
-        long long slot = -1;
-        bool hasSlot = false;
-        if (std::regex_search(payload, m, std::regex("slot=([0-9]+)"))) {
-            slot = std::stoll(m[1].str());
-            hasSlot = true;
+        SvSample sample = decodeSvPayload(payload);
+
+        // PRP：LAN A/B 上同一 (src, seq) 只保留先到的一份，后到副本不参与统计与差动计算；
+        // 带 src 字段但 src/seq 无法解析的报文计为格式错误并丢弃
+        if (prpEnabled && payload.find("src=") != std::string::npos) {
+            if (sample.src < 0 || sample.seq < 0) {
+                prpMalformedCount++;
+                delete packet;
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            auto result = prpTable.check(sample.src, sample.seq);
+            prpDiscardWallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            prpDiscardChecks++;
+            if (result != PrpDiscardTable::ACCEPTED) {
+                if (result == PrpDiscardTable::DUPLICATE)
+                    prpDuplicateCount++;
+                else
+                    prpOutOfWindowCount++;
+                delete packet;
+                return;
+            }
         }
 
         // 计算端到端时延和抖动（基于 Packet 创建时间）
@@ -201,7 +246,6 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
                 lastDelayLocal = delay;
                 hasDelayLocal = true;
             }
-            lastLocal = value;
         } else {
             remoteRxCount++;
             if (recordStats) {
@@ -212,79 +256,27 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
                 lastDelayRemote = delay;
                 hasDelayRemote = true;
             }
-            lastRemote = value;
         }
 
         // 释放 packet（我们没有进一步解析其 payload）
         delete packet;
 
-        if (std::isnan(value))
-            return;
-
-        // 严格按时隙标签匹配：同一 slot 成对后才计算差值
-        if (strictSlotMatch) {
-            // 没有 slot 字段则不参与配对
-            if (!hasSlot) {
-                EV_WARN << "SV packet missing slot tag; ignored in strict mode" << endl;
-                return;
-            }
-            // 将本地/远端样本按 slot 缓存
-            if (socket == &socketLocal)
-                localSamples[slot] = value;
-            else
-                remoteSamples[slot] = value;
-
-            // 清理过旧的样本，避免缓存无限增长
-            long long minSlot = slot - maxSlotLag;
-            if (maxSlotLag > 0) {
-                pruneOldSamples(localSamples, minSlot);
-                pruneOldSamples(remoteSamples, minSlot);
-            }
-
-            // 若本地与远端同一 slot 都已到达，则执行差动计算，这个xxxsamples是map类型的变量 slot:value
-            auto itLocal = localSamples.find(slot);
-            auto itRemote = remoteSamples.find(slot);
-            // 假如说没有找到对应 slot 的样本，find会返回end
-            if (itLocal != localSamples.end() && itRemote != remoteSamples.end()) {
-                double diff = fabs(itLocal->second - itRemote->second);
-                matchedSvCount++;
-                EV_INFO << "Differential(slot=" << slot << ") |I_local - I_remote| = " << diff
-                        << " A, threshold=" << threshold << endl;
-                if (diff > threshold) {
-                    overThresholdCount++;
-                    // 超阈值则发送 GOOSE Trip 报文
-                    auto goosePkt = new Packet("GOOSE:TripCommand");
-                    auto chunk = makeShared<ByteCountChunk>(B(64));
-                    goosePkt->insertAtBack(chunk);
-                    socketGoose.sendTo(goosePkt->dup(), gooseLocalDest, goosePort);
-                    socketGoose.sendTo(goosePkt, gooseRemoteDest, goosePort);
-                }
-                // 该 slot 已处理，移除缓存
-                localSamples.erase(slot);
-                remoteSamples.erase(slot);
-            }
+        // 严格模式下同一 slot 成对后才计算差值；非严格模式下两侧都有有效电流值时即比较
+        auto decision = engine.process(socket == &socketLocal, sample.current, sample.slot);
+        if (decision.missingSlot) {
+            EV_WARN << "SV packet missing slot tag; ignored in strict mode" << endl;
             return;
         }
-
-        // 非严格模式：当两侧都有有效电流值时计算差动并判决
-        if (!std::isnan(lastLocal) && !std::isnan(lastRemote)) {
-            double diff = fabs(lastLocal - lastRemote);
-            matchedSvCount++;
-            EV_INFO << "Differential |I_local - I_remote| = " << diff << " A, threshold=" << threshold << endl;
-            if (diff > threshold) {
-                overThresholdCount++;
-                // 构造一个简单的 GOOSE 包并发送到两个 IT 目的地
-                // 注意：这里用 ByteCountChunk(B(64)) 代表报文体占位，没有实现 GOOSE 格式细节
-                auto goosePkt = new Packet("GOOSE:TripCommand");
-                // DSCP 已通过 socket 的 IPv4 TOS 设置（在 initialize 阶段）；此处构造报文体占位。
-                auto chunk = makeShared<ByteCountChunk>(B(64));
-                goosePkt->insertAtBack(chunk);
-
-                // 发送两份副本：到本地 IT 和远端 IT
-                socketGoose.sendTo(goosePkt->dup(), gooseLocalDest, goosePort);
-                socketGoose.sendTo(goosePkt, gooseRemoteDest, goosePort);
-            }
-        }
+        if (!decision.evaluated)
+            return;
+        if (strictSlotMatch)
+            EV_INFO << "Differential(slot=" << decision.slot << ") |I_local - I_remote| = " << decision.diff
+                    << " A, threshold=" << threshold << endl;
+        else
+            EV_INFO << "Differential |I_local - I_remote| = " << decision.diff << " A, threshold=" << threshold << endl;
+        // 超阈值则发送 GOOSE Trip 报文
+        if (decision.trip)
+            sendGooseTrip();
     }
 
     // 处理 socket 错误回调（此处仅释放 indication）
@@ -300,13 +292,28 @@ class DifferentialProtectionApp : public cSimpleModule, public UdpSocket::ICallb
                 << ", remote=" << remoteRxCount << " packets" << endl;
         EV_INFO << getFullPath() << ": received total=" << (localRxCount + remoteRxCount)
             << " packets" << endl;
-        EV_INFO << getFullPath() << ": matchedSv=" << matchedSvCount
-            << ", overThreshold=" << overThresholdCount << endl;
+        EV_INFO << getFullPath() << ": matchedSv=" << engine.getMatchedCount()
+            << ", overThreshold=" << engine.getOverThresholdCount() << endl;
         recordScalar("localRxCount", localRxCount);
         recordScalar("remoteRxCount", remoteRxCount);
         recordScalar("totalRxCount", localRxCount + remoteRxCount);
-        recordScalar("matchedSvCount", matchedSvCount);
-        recordScalar("overThresholdCount", overThresholdCount);
+        recordScalar("matchedSvCount", engine.getMatchedCount());
+        recordScalar("overThresholdCount", engine.getOverThresholdCount());
+        if (prpEnabled) {
+            double nsPerPacket = prpDiscardChecks > 0 ? 1e9 * prpDiscardWallTime / prpDiscardChecks : 0.0;
+            EV_INFO << getFullPath() << ": prpDuplicates=" << prpDuplicateCount
+                    << ", prpOutOfWindow=" << prpOutOfWindowCount
+                    << ", prpMalformed=" << prpMalformedCount
+                    << ", prpLost=" << prpTable.getLostCount()
+                    << ", prpDiscardNsPerPacket=" << nsPerPacket << endl;
+            recordScalar("prpDuplicateCount", prpDuplicateCount);
+            recordScalar("prpOutOfWindowCount", prpOutOfWindowCount);
+            recordScalar("prpMalformedCount", prpMalformedCount);
+            recordScalar("prpLostCount", prpTable.getLostCount());
+            // prpDiscardChecks：进入剔除表（调用 prpTable.check()）的报文数，即 prpDiscardNsPerPacket 的样本数
+            recordScalar("prpDiscardChecks", prpDiscardChecks);
+            recordScalar("prpDiscardNsPerPacket", nsPerPacket);
+        }
     }
 };
 
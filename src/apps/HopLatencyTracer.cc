@@ -0,0 +1,297 @@
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <string>
+#include <utility>
+#include <omnetpp.h>
+#include "inet/common/INETDefs.h"
+#include "inet/common/ModuleAccess.h"
+#include "inet/common/TagBase.h"
+#include "inet/common/Units.h"
+#include "inet/common/packet/Packet.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+// HopTraceTag：挂在被抽样 SV/GOOSE 报文数据区上的逐跳时间戳（区域标签，随数据跨越节点转发）。
+// 跳数固定上限，超过后只置 overflow 标志，不再追加，保证标签大小不随路径增长。
+class HopTraceTag : public TagBase
+{
+  public:
+    static const int MAX_HOPS = 12;
+
+    struct Hop {
+        int nodeId = -1;             // 所在网络节点（交换机/路由器/主机）的模块 id
+        int portId = -1;             // 出口接口（eth[x]/ppp[x]）的模块 id
+        simtime_t ingress = -1.0;    // 进入节点时间（若 INET 未发出入口信号则等于入队时间）
+        simtime_t enqueue = -1.0;    // 进入出口队列时间
+        simtime_t gateOpen = -1.0;   // 报文最终被发送的那个门控窗口的开门时间
+        simtime_t transmit = -1.0;   // 从队列取出开始发送的时间
+    };
+
+    Hop hops[MAX_HOPS];
+    int numHops = 0;
+    bool overflow = false;
+
+    virtual HopTraceTag *dup() const override { return new HopTraceTag(*this); }
+};
+
+// HopLatencyTracer：
+//  - 可选开启的逐跳时延分解跟踪，按 sampleInterval 对 SV/GOOSE 报文抽样打标签；
+//  - 监听全网 PacketQueue 的 packetPushed/packetPulled 与 PeriodicGate 的 gateStateChanged，
+//    在报文标签上记录每一跳的入口、入队、开门、发送时间；
+//  - 按 (出口接口, 业务类型) 聚合处理时间、门控等待、排队、驻留与链路传输时间直方图。
+class HopLatencyTracer : public cSimpleModule, public cListener
+{
+  private:
+    struct HopStats {
+        cHistogram processing;  // ingress -> enqueue
+        cHistogram gateWait;    // enqueue -> gateOpen
+        cHistogram queueing;    // gateOpen -> transmit
+        cHistogram residence;   // ingress -> transmit
+        cHistogram transit;     // transmit -> 下一跳 ingress（链路/WAN/OTN）
+    };
+
+    struct GateState {
+        bool open = false;
+        simtime_t lastOpen = SIMTIME_ZERO;
+    };
+
+    simsignal_t packetPushedSignal = cComponent::registerSignal("packetPushed");
+    simsignal_t packetPulledSignal = cComponent::registerSignal("packetPulled");
+    simsignal_t packetReceivedFromLowerSignal = cComponent::registerSignal("packetReceivedFromLower");
+    simsignal_t gateStateChangedSignal = cComponent::registerSignal("gateStateChanged");
+
+    bool enabled = false;
+    int sampleInterval = 100;
+
+    // 门控模块 id -> 最近一次开门状态
+    std::map<int, GateState> gateStates;
+    // (出口接口模块 id, 业务类型) -> 逐跳时延直方图
+    std::map<std::pair<int, std::string>, HopStats> hopStats;
+    long sampledPackets = 0;
+    long overflowPackets = 0;
+
+    // 按报文树 id 做乘法哈希后取模，确定性抽样：同一报文在每一跳得到相同判定，且不消耗随机数流
+    bool isSampled(const Packet *packet) const {
+        uint64_t h = static_cast<uint64_t>(packet->getTreeId()) * 0x9E3779B97F4A7C15ULL;
+        return (h >> 32) % sampleInterval == 0;
+    }
+
+    static const char *classifyFlow(const char *packetName) {
+        if (strstr(packetName, "GOOSE") != nullptr)
+            return "GOOSE";
+        if (strstr(packetName, "SV") != nullptr)
+            return "SV";
+        return nullptr;
+    }
+
+    // 从队列模块向上找到所在接口（节点的直接子模块，例如 TSN_A_ACC_COMMON.eth[15]）
+    cModule *findPort(cModule *module, cModule *node) const {
+        while (module->getParentModule() != nullptr && module->getParentModule() != node)
+            module = module->getParentModule();
+        return module;
+    }
+
+    HopStats& statsFor(int portId, const char *flow) {
+        auto key = std::make_pair(portId, std::string(flow));
+        auto it = hopStats.find(key);
+        if (it == hopStats.end()) {
+            it = hopStats.emplace(key, HopStats()).first;
+            std::string prefix = getSimulation()->getModule(portId)->getFullPath() + ":" + flow + ":";
+            it->second.processing.setName((prefix + "processing").c_str());
+            it->second.gateWait.setName((prefix + "gateWait").c_str());
+            it->second.queueing.setName((prefix + "queueing").c_str());
+            it->second.residence.setName((prefix + "residence").c_str());
+            it->second.transit.setName((prefix + "transit").c_str());
+        }
+        return it->second;
+    }
+
+    // 在节点 nodeId 上开启新的一跳，并把上一跳发送到本跳入口的时间计入上一跳出口的 transit
+    HopTraceTag::Hop *beginHop(HopTraceTag *tag, int nodeId, const char *flow, bool aggregate) {
+        if (tag->numHops >= HopTraceTag::MAX_HOPS) {
+            if (!tag->overflow && aggregate)
+                overflowPackets++;
+            tag->overflow = true;
+            return nullptr;
+        }
+        auto& hop = tag->hops[tag->numHops++];
+        hop.nodeId = nodeId;
+        hop.ingress = simTime();
+        if (aggregate && tag->numHops > 1) {
+            const auto& prev = tag->hops[tag->numHops - 2];
+            if (prev.portId != -1 && prev.transmit >= SIMTIME_ZERO)
+                statsFor(prev.portId, flow).transit.collect((hop.ingress - prev.transmit).dbl());
+        }
+        return &hop;
+    }
+
+    // 更新同一报文上所有区域标签分片（首部被剥离/重插后标签可能被切成多段）；只对第一段做统计
+    template <typename F>
+    void updateTags(Packet *packet, F f) {
+        bool first = true;
+        packet->mapAllRegionTagsForUpdate<HopTraceTag>(b(0), packet->getTotalLength(), [&] (b offset, b length, const Ptr<HopTraceTag>& tag) {
+            f(tag.get(), first);
+            first = false;
+        });
+    }
+
+    void handleIngress(cComponent *source, Packet *packet, const char *flow) {
+        cModule *node = findContainingNode(check_and_cast<cModule *>(source));
+        if (node == nullptr)
+            return;
+        int nodeId = node->getId();
+        updateTags(packet, [&] (HopTraceTag *tag, bool aggregate) {
+            if (tag->numHops > 0 && tag->hops[tag->numHops - 1].nodeId == nodeId && tag->hops[tag->numHops - 1].transmit < SIMTIME_ZERO)
+                return;
+            beginHop(tag, nodeId, flow, aggregate);
+        });
+    }
+
+    void handleEnqueue(cComponent *source, Packet *packet, const char *flow) {
+        cModule *queue = check_and_cast<cModule *>(source);
+        cModule *node = findContainingNode(queue);
+        if (node == nullptr)
+            return;
+        int nodeId = node->getId();
+        int portId = findPort(queue, node)->getId();
+
+        // 首次在发送端出口队列看到被抽样报文时挂上标签
+        if (!packet->addRegionTagsWhereAbsent<HopTraceTag>(b(0), packet->getTotalLength()).empty())
+            sampledPackets++;
+
+        updateTags(packet, [&] (HopTraceTag *tag, bool aggregate) {
+            HopTraceTag::Hop *hop = nullptr;
+            if (tag->numHops > 0) {
+                auto& last = tag->hops[tag->numHops - 1];
+                if (last.nodeId == nodeId && last.enqueue < SIMTIME_ZERO)
+                    hop = &last;
+            }
+            if (hop == nullptr)
+                hop = beginHop(tag, nodeId, flow, aggregate);
+            if (hop == nullptr)
+                return;
+            hop->portId = portId;
+            hop->enqueue = simTime();
+        });
+    }
+
+    void handleTransmit(cComponent *source, Packet *packet, const char *flow) {
+        cModule *queue = check_and_cast<cModule *>(source);
+        cModule *node = findContainingNode(queue);
+        if (node == nullptr)
+            return;
+        int nodeId = node->getId();
+
+        // Ieee8021qTimeAwareShaper 中 queue[i] 对应同级的 transmissionGate[i]
+        const GateState *gate = nullptr;
+        if (queue->isVector()) {
+            cModule *gateModule = queue->getParentModule()->getSubmodule("transmissionGate", queue->getIndex());
+            if (gateModule != nullptr) {
+                auto it = gateStates.find(gateModule->getId());
+                if (it != gateStates.end())
+                    gate = &it->second;
+            }
+        }
+
+        updateTags(packet, [&] (HopTraceTag *tag, bool aggregate) {
+            if (tag->numHops == 0)
+                return;
+            auto& hop = tag->hops[tag->numHops - 1];
+            if (hop.nodeId != nodeId || hop.enqueue < SIMTIME_ZERO || hop.transmit >= SIMTIME_ZERO)
+                return;
+            hop.transmit = simTime();
+            hop.gateOpen = hop.enqueue;
+            if (gate != nullptr && gate->lastOpen > hop.enqueue)
+                hop.gateOpen = gate->lastOpen;
+            if (aggregate) {
+                auto& s = statsFor(hop.portId, flow);
+                s.processing.collect((hop.enqueue - hop.ingress).dbl());
+                s.gateWait.collect((hop.gateOpen - hop.enqueue).dbl());
+                s.queueing.collect((hop.transmit - hop.gateOpen).dbl());
+                s.residence.collect((hop.transmit - hop.ingress).dbl());
+            }
+        });
+    }
+
+  protected:
+    virtual void initialize() override {
+        enabled = par("enabled");
+        sampleInterval = par("sampleInterval");
+        if (sampleInterval <= 0)
+            throw cRuntimeError("sampleInterval must be > 0");
+        if (!enabled)
+            return;
+
+        // 未开启时不订阅任何信号，对仿真零开销
+        auto systemModule = getSimulation()->getSystemModule();
+        systemModule->subscribe(packetPushedSignal, this);
+        systemModule->subscribe(packetPulledSignal, this);
+        systemModule->subscribe(packetReceivedFromLowerSignal, this);
+        systemModule->subscribe(gateStateChangedSignal, this);
+    }
+
+    virtual void finish() override {
+        if (!enabled)
+            return;
+
+        EV_INFO << "\n========== Hop Latency Breakdown ==========" << endl;
+        EV_INFO << "HopTrace: sampled_packets=" << sampledPackets
+                << ", sample_interval=" << sampleInterval
+                << ", hop_overflow_packets=" << overflowPackets << endl;
+        for (auto& item : hopStats) {
+            auto& s = item.second;
+            if (s.residence.getCount() == 0 && s.transit.getCount() == 0)
+                continue;
+            EV_INFO << "HopLatency: "
+                    << "port=" << getSimulation()->getModule(item.first.first)->getFullPath()
+                    << ", flow=" << item.first.second
+                    << ", samples=" << s.residence.getCount()
+                    << ", avg_processing_us=" << 1e6 * s.processing.getMean()
+                    << ", avg_gate_wait_us=" << 1e6 * s.gateWait.getMean()
+                    << ", max_gate_wait_us=" << 1e6 * s.gateWait.getMax()
+                    << ", avg_queueing_us=" << 1e6 * s.queueing.getMean()
+                    << ", avg_residence_us=" << 1e6 * s.residence.getMean()
+                    << ", max_residence_us=" << 1e6 * s.residence.getMax()
+                    << ", avg_transit_us=" << 1e6 * s.transit.getMean()
+                    << endl;
+            recordStatistic(&s.processing, "s");
+            recordStatistic(&s.gateWait, "s");
+            recordStatistic(&s.queueing, "s");
+            recordStatistic(&s.residence, "s");
+            recordStatistic(&s.transit, "s");
+        }
+        EV_INFO << "===========================================\n" << endl;
+    }
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, cObject *obj, cObject *details) override {
+        auto packet = dynamic_cast<Packet *>(obj);
+        if (packet == nullptr)
+            return;
+        // 先做抽样哈希（只需树 id），绝大多数报文在此返回；仅被抽样报文才按名字分类
+        if (!isSampled(packet))
+            return;
+        const char *flow = classifyFlow(packet->getName());
+        if (flow == nullptr)
+            return;
+
+        if (signalID == packetPushedSignal)
+            handleEnqueue(source, packet, flow);
+        else if (signalID == packetPulledSignal)
+            handleTransmit(source, packet, flow);
+        else if (signalID == packetReceivedFromLowerSignal)
+            handleIngress(source, packet, flow);
+    }
+
+    virtual void receiveSignal(cComponent *source, simsignal_t signalID, bool value, cObject *details) override {
+        if (signalID != gateStateChangedSignal)
+            return;
+        auto& gate = gateStates[source->getId()];
+        if (value && !gate.open)
+            gate.lastOpen = simTime();
+        gate.open = value;
+    }
+};
+
+Define_Module(HopLatencyTracer);
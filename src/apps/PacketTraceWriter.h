@@ -0,0 +1,201 @@
+#ifndef __SMARTSUBSTATION_PACKETTRACEWRITER_H
+#define __SMARTSUBSTATION_PACKETTRACEWRITER_H
+
+#include <omnetpp.h>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// PacketTraceWriter：逐包二进制列式跟踪文件（.ptr）写入器。
+//
+// 文件布局（小端，全部定长，可整体 mmap 后按偏移零拷贝访问）：
+//  - 文件头 64 字节：
+//      char     magic[8]        = "SSPKTTRC"
+//      uint32_t version         = 2（版本 1 的列之间无填充，容量非 8 的倍数时后续列不对齐）
+//      uint32_t headerSize      = 64
+//      int32_t  simtimeScaleExp   时间戳原始刻度的 10 的指数（OMNeT++ 默认 -12，即 ps）
+//      uint32_t blockCapacity     每块记录数（所有块按该容量定长布局）
+//      uint64_t recordCount       总记录数（关闭时回填）
+//      uint64_t blockCount        总块数（关闭时回填）
+//      其余字节保留为 0
+//  - 之后为 blockCount 个定长数据块，第 k 块偏移 = 64 + k * blockBytes(blockCapacity)；
+//    块头 16 字节（uint64_t numRecords + 8 字节保留），随后按列依次存放 blockCapacity 个元素，
+//    仅前 numRecords 个有效。每列长度 = columnBytes(blockCapacity, 元素宽度)，即 blockCapacity * 宽度
+//    向上补零到 8 的倍数，因此任意容量下每列（以及下一块的块头）都从 8 字节边界开始：
+//      int64_t  time[]      事件时刻（simtime 原始刻度）
+//      int64_t  delay[]     端到端时延（原始刻度，发送事件为 -1）
+//      int64_t  packetId[]  报文树 id，可用于发送/接收事件配对
+//      uint32_t src[]       源 IPv4 地址（未知为 0）
+//      uint32_t dst[]       目的 IPv4 地址（未知为 0）；发送事件在报文进入 UdpSocket 之前发出，
+//                           尚无 L3 地址，src/dst 恒为 0，需要时按 packetId 与接收事件配对取得
+//      uint32_t module[]    发出信号的应用模块 id
+//      uint32_t bytes[]     报文长度（字节）
+//      uint8_t  event[]     0=发送 1=接收
+//      uint8_t  flow[]      业务类型编号：0=SV 1=GOOSE 2=VoIP 3=Video 4=OM_Data 5=Other
+//    块长 blockBytes = 16 + 各列 columnBytes 之和（容量为 8 的倍数时各列无填充）。
+//
+// 写文件失败（磁盘满等导致短写、定位或关闭失败）时抛出 cRuntimeError，不留下记录数与内容不符的文件。
+class PacketTraceWriter
+{
+  public:
+    static constexpr const char *MAGIC = "SSPKTTRC";
+    static const uint32_t VERSION = 2;
+    static const uint32_t HEADER_SIZE = 64;
+    static const uint32_t BLOCK_HEADER_SIZE = 16;
+    enum Event : uint8_t { SENT = 0, RECEIVED = 1 };
+
+    // 业务类型名 -> 编号（与 TrafficKpiReporter 的分类一致）
+    static uint8_t flowCode(const std::string& flowName) {
+        static const char *const names[] = {"SV", "GOOSE", "VoIP", "Video", "OM_Data"};
+        for (uint8_t i = 0; i < 5; i++)
+            if (flowName == names[i])
+                return i;
+        return 5;
+    }
+
+    // 单列占用字节数：元素区向上补齐到 8 字节
+    static size_t columnBytes(uint32_t capacity, size_t elementSize) {
+        return ((size_t)capacity * elementSize + 7) & ~(size_t)7;
+    }
+
+    static size_t blockBytes(uint32_t capacity) {
+        return BLOCK_HEADER_SIZE + 3 * columnBytes(capacity, 8) + 4 * columnBytes(capacity, 4) + 2 * columnBytes(capacity, 1);
+    }
+
+  private:
+    std::FILE *file = nullptr;
+    std::string fileName;
+    uint32_t blockCapacity = 0;
+    int32_t scaleExp = -12;
+    uint64_t recordCount = 0;
+    uint64_t blockCount = 0;
+
+    // 当前块的列缓冲
+    std::vector<int64_t> time, delay, packetId;
+    std::vector<uint32_t> src, dst, module, bytes;
+    std::vector<uint8_t> event, flow;
+    std::vector<char> blockBuffer;
+
+    void writeBytes(const void *data, size_t size) {
+        size_t written = std::fwrite(data, 1, size, file);
+        if (written != size)
+            throw omnetpp::cRuntimeError("PacketTraceWriter: short write to '%s' (%zu of %zu bytes): %s",
+                                         fileName.c_str(), written, size, strerror(errno));
+    }
+
+    template <typename T>
+    char *appendColumn(char *out, const std::vector<T>& column) {
+        size_t used = column.size() * sizeof(T);
+        std::memcpy(out, column.data(), used);
+        size_t total = columnBytes(blockCapacity, sizeof(T));
+        std::memset(out + used, 0, total - used);
+        return out + total;
+    }
+
+    void writeHeader() {
+        char header[HEADER_SIZE] = {};
+        uint32_t version = VERSION;
+        uint32_t headerSize = HEADER_SIZE;
+        std::memcpy(header, MAGIC, 8);
+        std::memcpy(header + 8, &version, 4);
+        std::memcpy(header + 12, &headerSize, 4);
+        std::memcpy(header + 16, &scaleExp, 4);
+        std::memcpy(header + 20, &blockCapacity, 4);
+        std::memcpy(header + 24, &recordCount, 8);
+        std::memcpy(header + 32, &blockCount, 8);
+        if (std::fseek(file, 0, SEEK_SET) != 0)
+            throw omnetpp::cRuntimeError("PacketTraceWriter: cannot seek in '%s': %s", fileName.c_str(), strerror(errno));
+        writeBytes(header, HEADER_SIZE);
+    }
+
+    // 将当前块一次性组装并整块写出
+    void flushBlock() {
+        if (time.empty())
+            return;
+        std::memset(blockBuffer.data(), 0, blockBuffer.size());
+        uint64_t numRecords = time.size();
+        std::memcpy(blockBuffer.data(), &numRecords, 8);
+        char *out = blockBuffer.data() + BLOCK_HEADER_SIZE;
+        out = appendColumn(out, time);
+        out = appendColumn(out, delay);
+        out = appendColumn(out, packetId);
+        out = appendColumn(out, src);
+        out = appendColumn(out, dst);
+        out = appendColumn(out, module);
+        out = appendColumn(out, bytes);
+        out = appendColumn(out, event);
+        appendColumn(out, flow);
+        writeBytes(blockBuffer.data(), blockBuffer.size());
+        blockCount++;
+        time.clear(); delay.clear(); packetId.clear();
+        src.clear(); dst.clear(); module.clear(); bytes.clear();
+        event.clear(); flow.clear();
+    }
+
+  public:
+    // 正常流程由 finish() 调用 close()；析构时不再抛出写错误
+    ~PacketTraceWriter() {
+        try {
+            close();
+        }
+        catch (...) {
+        }
+    }
+
+    // 打开失败返回 false；写入/关闭失败抛出 cRuntimeError
+    bool open(const std::string& traceFileName, uint32_t capacity, int32_t simtimeScaleExp) {
+        close();
+        file = std::fopen(traceFileName.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        fileName = traceFileName;
+        blockCapacity = capacity;
+        scaleExp = simtimeScaleExp;
+        recordCount = 0;
+        blockCount = 0;
+        time.reserve(capacity); delay.reserve(capacity); packetId.reserve(capacity);
+        src.reserve(capacity); dst.reserve(capacity); module.reserve(capacity); bytes.reserve(capacity);
+        event.reserve(capacity); flow.reserve(capacity);
+        blockBuffer.assign(blockBytes(capacity), 0);
+        writeHeader();
+        return true;
+    }
+
+    bool isOpen() const { return file != nullptr; }
+
+    void write(int64_t t, int64_t d, int64_t id, uint32_t s, uint32_t ds, uint32_t m, uint32_t b, uint8_t e, uint8_t f) {
+        time.push_back(t); delay.push_back(d); packetId.push_back(id);
+        src.push_back(s); dst.push_back(ds); module.push_back(m); bytes.push_back(b);
+        event.push_back(e); flow.push_back(f);
+        recordCount++;
+        if (time.size() >= blockCapacity)
+            flushBlock();
+    }
+
+    uint64_t getRecordCount() const { return recordCount; }
+
+    // 写出残余块并回填文件头中的记录数/块数
+    void close() {
+        if (file == nullptr)
+            return;
+        try {
+            flushBlock();
+            writeHeader();
+        }
+        catch (...) {
+            std::fclose(file);
+            file = nullptr;
+            throw;
+        }
+        // 残余的 stdio 缓冲在 fclose 时才真正写出，其失败同样视为写错误
+        int result = std::fclose(file);
+        file = nullptr;
+        if (result != 0)
+            throw omnetpp::cRuntimeError("PacketTraceWriter: cannot close '%s': %s", fileName.c_str(), strerror(errno));
+    }
+};
+
+#endif
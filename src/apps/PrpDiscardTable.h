@@ -0,0 +1,74 @@
+#ifndef __SMARTSUBSTATION_PRPDISCARDTABLE_H
+#define __SMARTSUBSTATION_PRPDISCARDTABLE_H
+
+#include <unordered_map>
+#include <vector>
+
+// PrpDiscardTable：
+//  - IEC 62439-3 PRP 接收端的重复帧剔除表，每个源一个固定大小的滑动窗口；
+//  - 窗口按 seq % windowSize 直接寻址，每个报文只访问一个槽位，查找/插入均为 O(1)；
+//  - 窗口大小需覆盖 LAN A/LAN B 两条路径的最大时延差对应的序号跨度
+//    （例如 4kHz SV、窗口 1024 可容忍约 256ms 的路径差）。
+class PrpDiscardTable
+{
+  public:
+    enum Result {
+        ACCEPTED,       // 首次到达，交给上层处理
+        DUPLICATE,      // 另一条 LAN 上的副本已先到达，丢弃
+        OUT_OF_WINDOW   // 序号比窗口下沿还旧，无法判定，按重复丢弃
+    };
+
+  private:
+    struct Window {
+        std::vector<long long> slots;
+        long long firstSeq = -1;
+        long long maxSeq = -1;
+        long accepted = 0;
+    };
+
+    int windowSize;
+    std::unordered_map<int, Window> windows;
+
+  public:
+    explicit PrpDiscardTable(int windowSize = 1024) : windowSize(windowSize) {}
+
+    void setWindowSize(int size) {
+        windowSize = size;
+        windows.clear();
+    }
+
+    Result check(int sourceId, long long seq) {
+        auto& w = windows[sourceId];
+        if (w.slots.empty()) {
+            w.slots.assign(windowSize, -1);
+            w.firstSeq = seq;
+        }
+        if (w.maxSeq >= 0 && seq <= w.maxSeq - windowSize)
+            return OUT_OF_WINDOW;
+        auto& slot = w.slots[seq % windowSize];
+        if (slot == seq)
+            return DUPLICATE;
+        slot = seq;
+        if (seq > w.maxSeq)
+            w.maxSeq = seq;
+        if (seq < w.firstSeq)
+            w.firstSeq = seq;
+        w.accepted++;
+        return ACCEPTED;
+    }
+
+    // 两条 LAN 都未送达的序号数（按各源已见序号区间统计）
+    long getLostCount() const {
+        long lost = 0;
+        for (const auto& item : windows) {
+            const auto& w = item.second;
+            if (w.maxSeq >= 0)
+                lost += (long)(w.maxSeq - w.firstSeq + 1) - w.accepted;
+        }
+        return lost;
+    }
+
+    int getNumSources() const { return (int)windows.size(); }
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include <omnetpp.h>
+#include <chrono>
+#include <string>
+#include "inet/common/INETDefs.h"
+#include "inet/common/InitStages.h"
+#include "inet/common/packet/Packet.h"
+#include "inet/common/packet/chunk/BytesChunk.h"
+#include "inet/transportlayer/contract/udp/UdpSocket.h"
+#include "PrpDiscardTable.h"
+#include "SvSampleGenerator.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+// PrpSinkApp：
+//  - PRP 双网冗余下的 GOOSE 接收端（替代 UdpSink），在 LAN A/B 两个接口上监听同一 UDP 端口；
+//  - 按负载中的 (src, seq) 用固定大小滑动窗口剔除重复副本，只有先到的一份被计数并发出 packetReceived；
+//  - 负载中没有 src 字段的报文（未开启 PRP 的发送端）直接接收，行为与 UdpSink 一致；
+//    带 src 字段但 src/seq 缺失或无法解析的报文计为格式错误并丢弃，不进入剔除表。
+class PrpSinkApp : public cSimpleModule, public UdpSocket::ICallback
+{
+  private:
+    UdpSocket socket;
+    int localPort = -1;
+    PrpDiscardTable prpTable;
+
+    simsignal_t packetReceivedSignal = cComponent::registerSignal("packetReceived");
+
+    long rxCount = 0;
+    long duplicateCount = 0;
+    long outOfWindowCount = 0;
+    long malformedCount = 0;
+    // 剔除判定耗时（墙钟，仅 prpTable.check()）与进入剔除表的报文数（不含无 src 的直通报文与格式错误报文）
+    double discardWallTime = 0;
+    long discardChecks = 0;
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+
+    virtual void initialize(int stage) override {
+        cSimpleModule::initialize(stage);
+        if (stage == INITSTAGE_LOCAL) {
+            localPort = par("localPort");
+            int windowSize = par("prpWindowSize");
+            if (windowSize <= 0)
+                throw cRuntimeError("prpWindowSize must be > 0");
+            prpTable.setWindowSize(windowSize);
+        }
+        else if (stage == INITSTAGE_APPLICATION_LAYER) {
+            // 不绑定本地地址，LAN A/B 两个接口上的报文都由该 socket 接收
+            socket.setOutputGate(gate("socketOut"));
+            socket.setCallback(this);
+            socket.bind(localPort);
+        }
+    }
+
+    virtual void handleMessage(cMessage *msg) override {
+        if (socket.belongsToSocket(msg))
+            socket.processMessage(msg);
+        else
+            delete msg;
+    }
+
+    virtual void socketDataArrived(UdpSocket *socket, Packet *packet) override {
+        std::string payload;
+        auto bytesChunk = dynamicPtrCast<const BytesChunk>(packet->peekAtFront<Chunk>());
+        if (bytesChunk != nullptr) {
+            const auto& bytes = bytesChunk->getBytes();
+            payload.assign(bytes.begin(), bytes.end());
+        }
+
+        // 负载字段解析与 SV 共用 decodeSvPayload；解析不计入剔除开销
+        SvSample fields = decodeSvPayload(payload);
+        int src = fields.src;
+        long long seq = fields.seq;
+        if (payload.find("src=") != std::string::npos) {
+            if (src < 0 || seq < 0) {
+                malformedCount++;
+                delete packet;
+                return;
+            }
+            auto start = std::chrono::steady_clock::now();
+            auto result = prpTable.check(src, seq);
+            discardWallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            discardChecks++;
+            if (result != PrpDiscardTable::ACCEPTED) {
+                if (result == PrpDiscardTable::DUPLICATE)
+                    duplicateCount++;
+                else
+                    outOfWindowCount++;
+                delete packet;
+                return;
+            }
+        }
+
+        rxCount++;
+        EV_INFO << "Received " << packet->getName() << " (src=" << src << ", seq=" << seq << ")" << endl;
+        emit(packetReceivedSignal, packet);
+        delete packet;
+    }
+
+    virtual void socketErrorArrived(UdpSocket *socket, Indication *indication) override {
+        delete indication;
+    }
+
+    virtual void socketClosed(UdpSocket *socket) override {}
+
+    virtual void finish() override {
+        double nsPerPacket = discardChecks > 0 ? 1e9 * discardWallTime / discardChecks : 0.0;
+        EV_INFO << getFullPath() << ": received=" << rxCount
+                << ", prpDuplicates=" << duplicateCount
+                << ", prpOutOfWindow=" << outOfWindowCount
+                << ", prpMalformed=" << malformedCount
+                << ", prpLost=" << prpTable.getLostCount()
+                << ", prpDiscardNsPerPacket=" << nsPerPacket << endl;
+        recordScalar("rxCount", rxCount);
+        recordScalar("prpDuplicateCount", duplicateCount);
+        recordScalar("prpOutOfWindowCount", outOfWindowCount);
+        recordScalar("prpMalformedCount", malformedCount);
+        recordScalar("prpLostCount", prpTable.getLostCount());
+        // prpDiscardChecks：进入剔除表（调用 prpTable.check()）的报文数，即 prpDiscardNsPerPacket 的样本数
+        recordScalar("prpDiscardChecks", discardChecks);
+        recordScalar("prpDiscardNsPerPacket", nsPerPacket);
+    }
+};
+
+Define_Module(PrpSinkApp);
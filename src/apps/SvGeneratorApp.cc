@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include "inet/common/INETDefs.h"
+#include "inet/common/ModuleAccess.h"
 #include "inet/common/packet/Packet.h"
 #include "inet/common/Units.h"
 #include "inet/common/packet/chunk/ByteCountChunk.h"
@@ -10,6 +11,7 @@
 #include "inet/networklayer/common/L3AddressResolver.h"
 #include "inet/common/InitStages.h"
 #include "inet/transportlayer/contract/udp/UdpSocket.h"
+#include "SvSampleGenerator.h"
 
 using namespace omnetpp;
 using namespace inet;
@@ -27,17 +29,21 @@ class SvGeneratorApp : public cSimpleModule
     int localPort;
     L3Address remoteDest;
     int remotePort;
-    double base;
-    double noise;
+    // 采样值生成（基值/噪声/故障扰动/时隙与序号），与 SvReplayerApp 共用；
+    // noisePregenerate > 0 时噪声只取决于帧序号，与事件交织顺序无关（公共随机数 A/B 对比用）
+    SvSampleGenerator generator;
     int msgLenBytes;
     simtime_t interval;
-    bool faultEnabled = false;
-    simtime_t faultStart;
-    simtime_t faultDuration;
-    double faultDelta = 0;
     int dscp = 56;
-    long long seq = 0;
+    // PRP 双网冗余：同一帧（同一 seq）再经 LAN B 各发送一份
+    bool prpEnabled = false;
+    L3Address localDestB;
+    L3Address remoteDestB;
+    int sourceId = -1;
+    // 逻辑帧发送数（每个采样本地/远端各一份，与是否开启 PRP 无关），与接收端剔除重复后的计数同口径
     long txCount = 0;
+    // PRP 经 LAN B 额外发送的冗余副本数
+    long txCountLanB = 0;
 
   protected:
     // 指定需要的初始化阶段数（常量由 INET/OMNeT 提供）
@@ -52,21 +58,24 @@ class SvGeneratorApp : public cSimpleModule
             // 只读取参数（安全，不依赖于网络接口）
             localPort = par("localDestPort");
             remotePort = par("remoteDestPort");
-            base = par("currentBase");
-            noise = par("noiseStd");
+            generator.configure(this);
+            interval = generator.getInterval();
             msgLenBytes = par("messageLength");
-            interval = par("sendInterval");
-            faultEnabled = par("faultEnabled");
-            faultStart = par("faultStart");
-            faultDuration = par("faultDuration");
-            faultDelta = par("faultDelta");
             dscp = par("dscp");
+            prpEnabled = par("prpEnabled");
             timer = new cMessage("sendTimer");
         }
         else if (stage == INITSTAGE_APPLICATION_LAYER) {
             // 此时接口表已建立，可以解析名字到地址
             localDest = L3AddressResolver().resolve(par("localDestAddress"));
             remoteDest = L3AddressResolver().resolve(par("remoteDestAddress"));
+            if (prpEnabled) {
+                // LAN B 地址通常写成 "Protection_B%eth1"，指向目的主机的第二个接口
+                localDestB = L3AddressResolver().resolve(par("localDestAddressB"));
+                remoteDestB = L3AddressResolver().resolve(par("remoteDestAddressB"));
+                // 源标识取发送节点模块 id，两条 LAN 上的副本相同，接收端据此按源剔除重复
+                sourceId = getContainingNode(this)->getId();
+            }
 
             // 配置 UDP socket 并绑定输出 gate
             socket.setOutputGate(gate("socketOut"));
@@ -83,18 +92,16 @@ class SvGeneratorApp : public cSimpleModule
     virtual void handleMessage(cMessage *msg) override {
         // 定时器触发时发送一帧 SV
         if (msg == timer) {
-            // 生成带故障扰动的采样值，但是事实上infault就算是false，计算过程中也会出现超过阈值的情况，因为噪声的存在可能导致采样值偏离基值超过阈值。
-            bool inFault = faultEnabled && simTime() >= faultStart && simTime() < (faultStart + faultDuration);
-            double mean = base + (inFault ? faultDelta : 0.0); // base是来自于currentBase
-            double value = normal(mean, noise);
+            // 生成带故障扰动的采样值（均值为 currentBase，故障窗口内叠加 faultDelta），但是事实上infault就算是false，
+            // 计算过程中也会出现超过阈值的情况，因为噪声的存在可能导致采样值偏离基值超过阈值。
             // slot 计算：基于发送时间与发送间隔计算时隙编号，interval是demo传进来的报文发送间隔
             // floor的作用在于向下取整，确保时隙编号是整数
-            long long slot = (long long)floor(simTime().dbl() / interval.dbl());
+            SvSample sample = generator.next(simTime());
+            if (prpEnabled)
+                sample.src = sourceId;
 
             // 将业务字段写入报文负载，而不是写到 packet name 里。
-            std::string payload = "slot=" + std::to_string(slot)
-                                + ";seq=" + std::to_string(seq)
-                                + ";current=" + std::to_string(value);
+            std::string payload = encodeSvPayload(sample);
             std::vector<uint8_t> payloadBytes(payload.begin(), payload.end());
 
             auto packet = new Packet("SV");
@@ -110,9 +117,14 @@ class SvGeneratorApp : public cSimpleModule
             }
             // 发送到本地保护（本地复制）和远端保护
             socket.sendTo(packet->dup(), localDest, localPort);
+            if (prpEnabled) {
+                // PRP：相同内容经 LAN B 再发一份，接收端保留先到的一份
+                socket.sendTo(packet->dup(), localDestB, localPort);
+                socket.sendTo(packet->dup(), remoteDestB, remotePort);
+                txCountLanB += 2;
+            }
             socket.sendTo(packet, remoteDest, remotePort);
             txCount += 2;
-            seq++;
             // 安排下一次发送
             scheduleAt(simTime() + interval, timer);
         }
@@ -124,8 +136,11 @@ class SvGeneratorApp : public cSimpleModule
 
     virtual void finish() override {
         cancelAndDelete(timer);
-        EV_INFO << getFullPath() << ": sent SV packets=" << txCount << endl;
+        EV_INFO << getFullPath() << ": sent SV packets=" << txCount
+                << (prpEnabled ? ", LAN B copies=" + std::to_string(txCountLanB) : std::string()) << endl;
         recordScalar("svTxCount", txCount);
+        if (prpEnabled)
+            recordScalar("svTxCountLanB", txCountLanB);
     }
 };
 
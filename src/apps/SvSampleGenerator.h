@@ -0,0 +1,112 @@
+#ifndef __SMARTSUBSTATION_SVSAMPLEGENERATOR_H
+#define __SMARTSUBSTATION_SVSAMPLEGENERATOR_H
+
+#include <omnetpp.h>
+#include <cmath>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// SV 负载字段：slot/seq/current 为基本字段，src（PRP 源标识）与 txns（发送时刻，单调时钟纳秒）可选
+struct SvSample {
+    long long slot = -1;
+    long long seq = -1;
+    double current = NAN;
+    int src = -1;
+    long long txNs = -1;
+};
+
+// 负载编码："slot=..;seq=..;current=..[;src=..][;txns=..]"
+inline std::string encodeSvPayload(const SvSample& sample) {
+    std::string payload = "slot=" + std::to_string(sample.slot)
+                        + ";seq=" + std::to_string(sample.seq)
+                        + ";current=" + std::to_string(sample.current);
+    if (sample.src >= 0)
+        payload += ";src=" + std::to_string(sample.src);
+    if (sample.txNs >= 0)
+        payload += ";txns=" + std::to_string(sample.txNs);
+    return payload;
+}
+
+// 负载解析：缺失或无法转换（例如数值溢出）的字段保持默认值（-1 或 NaN）
+inline SvSample decodeSvPayload(const std::string& payload) {
+    static const std::regex currentPattern("current=([+-]?[0-9]*\\.?[0-9]+)");
+    static const std::regex slotPattern("slot=([0-9]+)");
+    static const std::regex seqPattern("seq=([0-9]+)");
+    static const std::regex srcPattern("src=([0-9]+)");
+    static const std::regex txPattern("txns=([0-9]+)");
+    SvSample sample;
+    std::smatch m;
+    auto field = [&] (const std::regex& pattern, auto convert, auto& value) {
+        if (!std::regex_search(payload, m, pattern))
+            return;
+        try {
+            value = convert(m[1].str());
+        }
+        catch (const std::exception&) {
+        }
+    };
+    auto toDouble = [] (const std::string& text) { return std::stod(text); };
+    auto toLong = [] (const std::string& text) { return std::stoll(text); };
+    auto toInt = [] (const std::string& text) { return std::stoi(text); };
+    field(currentPattern, toDouble, sample.current);
+    field(slotPattern, toLong, sample.slot);
+    field(seqPattern, toLong, sample.seq);
+    field(srcPattern, toInt, sample.src);
+    field(txPattern, toLong, sample.txNs);
+    return sample;
+}
+
+// SvSampleGenerator：SvGeneratorApp 与 SvReplayerApp 共用的采样值生成逻辑
+//  - 从所属模块读取 currentBase/noiseStd/sendInterval/fault*/noisePregenerate 参数；
+//  - 采样值 = 基值（故障窗口内叠加 faultDelta）+ 正态噪声，噪声取自所属模块的随机数流 0，
+//    noisePregenerate > 0 时在 configure() 中预生成标准正态序列并按 seq 循环使用；
+//  - slot 由发送时刻与发送间隔计算，seq 每帧递增。
+class SvSampleGenerator
+{
+  private:
+    omnetpp::cComponent *owner = nullptr;
+    double base = 0;
+    double noise = 0;
+    omnetpp::simtime_t interval;
+    bool faultEnabled = false;
+    omnetpp::simtime_t faultStart;
+    omnetpp::simtime_t faultDuration;
+    double faultDelta = 0;
+    std::vector<double> noiseSequence;
+    long long seq = 0;
+
+  public:
+    void configure(omnetpp::cComponent *module) {
+        owner = module;
+        base = module->par("currentBase");
+        noise = module->par("noiseStd");
+        interval = module->par("sendInterval");
+        faultEnabled = module->par("faultEnabled");
+        faultStart = module->par("faultStart");
+        faultDuration = module->par("faultDuration");
+        faultDelta = module->par("faultDelta");
+        int pregenerate = module->par("noisePregenerate");
+        noiseSequence.clear();
+        for (int i = 0; i < pregenerate; i++)
+            noiseSequence.push_back(omnetpp::normal(module->getRNG(0), 0, 1));
+    }
+
+    omnetpp::simtime_t getInterval() const { return interval; }
+
+    SvSample next(omnetpp::simtime_t now) {
+        // 故障窗口内叠加故障电流；即使不在故障窗口，噪声也可能使差值越过阈值
+        bool inFault = faultEnabled && now >= faultStart && now < (faultStart + faultDuration);
+        double mean = base + (inFault ? faultDelta : 0.0);
+        SvSample sample;
+        sample.current = noiseSequence.empty() ? omnetpp::normal(owner->getRNG(0), mean, noise)
+                                               : mean + noise * noiseSequence[seq % noiseSequence.size()];
+        // 时隙编号：发送时刻按发送间隔向下取整
+        sample.slot = (long long)floor(now.dbl() / interval.dbl());
+        sample.seq = seq++;
+        return sample;
+    }
+};
+
+#endif
@@ -1,11 +1,15 @@
 #include <cmath>
 #include <map>
-#include <set>
 #include <string>
 #include <vector>
 #include <omnetpp.h>
 #include "inet/common/INETDefs.h"
+#include "inet/common/Units.h"
 #include "inet/common/packet/Packet.h"
+#include "inet/networklayer/common/L3AddressTag_m.h"
+#include "inet/queueing/contract/IPacketGate.h"
+#include "inet/queueing/contract/IPacketQueue.h"
+#include "PacketTraceWriter.h"
 
 using namespace omnetpp;
 using namespace inet;
@@ -28,64 +32,172 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
     simsignal_t packetSentSignal = cComponent::registerSignal("packetSent");
     simsignal_t packetReceivedSignal = cComponent::registerSignal("packetReceived");
     simsignal_t gateStateChangedSignal = cComponent::registerSignal("gateStateChanged");
+    simsignal_t packetPulledSignal = cComponent::registerSignal("packetPulled");
     std::map<std::string, FlowStats> stats;
 
+    // 每个门控窗口（一次 open -> close）的 TAS 效率统计，按门控汇总
     struct GateStats {
+        std::string path;
+        cModule *queue = nullptr;       // 与 transmissionGate[i] 同级的 queue[i]
+        double bitrate = 0;             // 出口接口速率（bps），用于折算发送占用时间；0 表示未知，不统计空闲时间
         bool initialized = false;
         bool currentOpen = false;
         simtime_t lastChangeTime = SIMTIME_ZERO;
         simtime_t openTime = SIMTIME_ZERO;
         long openEvents = 0;
         long closeEvents = 0;
+
+        // 当前窗口
+        long windowBytes = 0;
+        simtime_t windowBusyTime = SIMTIME_ZERO;
+
+        // 全部已结束窗口的累计值
+        long windows = 0;
+        long txBytes = 0;
+        simtime_t unusedOpenTime = SIMTIME_ZERO;
+        long missedFrames = 0;
+        long depthAtOpenSum = 0;
+        long maxDepthAtOpen = 0;
+
+        // 逐窗口向量（recordGateWindows=true 时创建）
+        cOutVector *windowBytesVec = nullptr;
+        cOutVector *unusedTimeVec = nullptr;
+        cOutVector *missedFramesVec = nullptr;
+        cOutVector *depthAtOpenVec = nullptr;
     };
-    std::map<std::string, GateStats> gateStats;
-    std::set<std::string> discoveredTsnSwitches;
-    std::set<std::string> discoveredGateModules;
+    // 门控模块 id -> 统计；queue 模块 id -> 门控模块 id
+    std::map<int, GateStats> gateStats;
+    std::map<int, int> gateByQueue;
 
+    bool recordGateWindows = false;
+    // 逐包二进制列式跟踪（traceFile 非空时开启）
+    PacketTraceWriter trace;
     int tsnSwitchCount = 0;
     int tsnShapingEnabledCount = 0;
     int transmissionGateModuleCount = 0;
 
-    void discoverAndSubscribe(cModule *module) {
-        if (module == nullptr)
-            return;
+    // 以太网帧在线路上额外占用：前导码+SFD 8B、FCS 4B、帧间隙 12B
+    static constexpr int ETHERNET_WIRE_OVERHEAD_BYTES = 24;
+
+    long queueDepth(const GateStats& gate) const {
+        auto queue = dynamic_cast<queueing::IPacketQueue *>(gate.queue);
+        return queue != nullptr ? queue->getNumPackets() : 0;
+    }
 
-        std::string fullPath = module->getFullPath();
-        std::string fullName = module->getFullName();
-        std::string nedType = module->getNedTypeName();
-
-        if (fullName.rfind("TSN_", 0) == 0 && module->hasPar("hasEgressTrafficShaping")) {
-            bool isNewSwitch = discoveredTsnSwitches.insert(fullPath).second;
-            if (isNewSwitch) {
-                tsnSwitchCount++;
-                bool enabled = module->par("hasEgressTrafficShaping").boolValue();
-                if (enabled)
-                    tsnShapingEnabledCount++;
-                EV_INFO << "TSNConfig: switch=" << fullPath
-                        << ", hasEgressTrafficShaping=" << (enabled ? "true" : "false") << endl;
+    // TSN 交换机都是网络的直接子模块，只检查这一层，不递归整棵模块树
+    void discoverTsnSwitches(cModule *network) {
+        for (cModule::SubmoduleIterator it(network); !it.end(); ++it) {
+            cModule *module = *it;
+            if (!module->hasPar("hasEgressTrafficShaping"))
+                continue;
+            tsnSwitchCount++;
+            bool enabled = module->par("hasEgressTrafficShaping").boolValue();
+            if (enabled)
+                tsnShapingEnabledCount++;
+            EV_INFO << "TSNConfig: switch=" << module->getFullPath()
+                    << ", hasEgressTrafficShaping=" << (enabled ? "true" : "false") << endl;
+            if (enabled && module->hasSubmoduleVector("eth")) {
+                for (int i = 0; i < module->getSubmoduleVectorSize("eth"); i++)
+                    registerPortGates(module->getSubmodule("eth", i));
             }
         }
+    }
 
-        bool isTransmissionGate = (module->hasPar("initiallyOpen") && module->hasPar("durations"))
-                      || nedType.find("PeriodicGate") != std::string::npos
-                      || fullName.find("transmissionGate") != std::string::npos;
-        if (isTransmissionGate) {
-            bool isNewGate = discoveredGateModules.insert(fullPath).second;
-            if (isNewGate) {
-                transmissionGateModuleCount++;
-                module->subscribe(gateStateChangedSignal, this);
-                bool initiallyOpen = module->hasPar("initiallyOpen") ? module->par("initiallyOpen").boolValue() : false;
-                std::string durations = module->hasPar("durations") ? module->par("durations").str() : "[]";
-                EV_INFO << "TSNGateConfig: gate=" << fullPath
-                        << ", type=" << nedType
-                        << ", initiallyOpen=" << (initiallyOpen ? "true" : "false")
-                        << ", durations=" << durations
-                        << endl;
-            }
+    // 按固定路径 eth[i].macLayer.queue.transmissionGate[j] / queue[j] 直接登记门控
+    void registerPortGates(cModule *port) {
+        if (port == nullptr)
+            return;
+        cModule *shaper = port->findModuleByPath(".macLayer.queue");
+        if (shaper == nullptr || !shaper->hasSubmoduleVector("transmissionGate"))
+            return;
+        // 接口 bitrate 未设置时为 NaN，此时无法折算发送占用时间，整窗会被误记为空闲，故不统计该端口的空闲时间
+        double bitrate = port->hasPar("bitrate") ? port->par("bitrate").doubleValue() : NAN;
+        if (!(bitrate > 0)) {
+            EV_WARN << "TrafficKpiReporter: port=" << port->getFullPath()
+                    << " has no valid bitrate, windowUnusedTime/unused_open_pct are not recorded for its gates" << endl;
+            bitrate = 0;
         }
+        for (int j = 0; j < shaper->getSubmoduleVectorSize("transmissionGate"); j++) {
+            cModule *gateModule = shaper->getSubmodule("transmissionGate", j);
+            if (gateModule != nullptr)
+                registerGate(gateModule, shaper->getSubmodule("queue", j), bitrate);
+        }
+    }
 
-        for (cModule::SubmoduleIterator it(module); !it.end(); ++it)
-            discoverAndSubscribe(*it);
+    void registerGate(cModule *gateModule, cModule *queue, double bitrate) {
+        auto& gate = gateStats[gateModule->getId()];
+        gate.path = gateModule->getFullPath();
+        gate.queue = queue;
+        gate.bitrate = bitrate;
+        transmissionGateModuleCount++;
+        gateModule->subscribe(gateStateChangedSignal, this);
+        if (queue != nullptr) {
+            gateByQueue[queue->getId()] = gateModule->getId();
+            queue->subscribe(packetPulledSignal, this);
+        }
+
+        // 以门控当前状态作为起点（其 initialize 已在本阶段之前完成）
+        auto packetGate = dynamic_cast<queueing::IPacketGate *>(gateModule);
+        bool initiallyOpen = gateModule->hasPar("initiallyOpen") ? gateModule->par("initiallyOpen").boolValue() : false;
+        gate.initialized = true;
+        gate.currentOpen = packetGate != nullptr ? packetGate->isOpen() : initiallyOpen;
+        gate.lastChangeTime = simTime();
+
+        if (recordGateWindows) {
+            gate.windowBytesVec = new cOutVector((gate.path + ":windowBytes").c_str());
+            if (gate.bitrate > 0)
+                gate.unusedTimeVec = new cOutVector((gate.path + ":windowUnusedTime").c_str());
+            gate.missedFramesVec = new cOutVector((gate.path + ":windowMissedFrames").c_str());
+            gate.depthAtOpenVec = new cOutVector((gate.path + ":depthAtOpen").c_str());
+        }
+        if (gate.currentOpen)
+            openWindow(gate);
+
+        std::string durations = gateModule->hasPar("durations") ? gateModule->par("durations").str() : "[]";
+        EV_INFO << "TSNGateConfig: gate=" << gate.path
+                << ", type=" << gateModule->getNedTypeName()
+                << ", initiallyOpen=" << (initiallyOpen ? "true" : "false")
+                << ", durations=" << durations
+                << endl;
+    }
+
+    void openWindow(GateStats& gate) {
+        long depth = queueDepth(gate);
+        gate.windowBytes = 0;
+        gate.windowBusyTime = SIMTIME_ZERO;
+        gate.depthAtOpenSum += depth;
+        if (depth > gate.maxDepthAtOpen)
+            gate.maxDepthAtOpen = depth;
+        if (gate.depthAtOpenVec != nullptr)
+            gate.depthAtOpenVec->record(depth);
+    }
+
+    void closeWindow(GateStats& gate, simtime_t windowLength) {
+        // 关门时仍在队列中的帧错过了本窗口，要再等一个完整周期
+        long missed = queueDepth(gate);
+        simtime_t busy = gate.windowBusyTime < windowLength ? gate.windowBusyTime : windowLength;
+        simtime_t unused = windowLength - busy;
+        gate.windows++;
+        gate.txBytes += gate.windowBytes;
+        if (gate.bitrate > 0)
+            gate.unusedOpenTime += unused;
+        gate.missedFrames += missed;
+        if (gate.windowBytesVec != nullptr) {
+            gate.windowBytesVec->record(gate.windowBytes);
+            if (gate.unusedTimeVec != nullptr)
+                gate.unusedTimeVec->record(unused);
+            gate.missedFramesVec->record(missed);
+        }
+    }
+
+  public:
+    virtual ~TrafficKpiReporter() {
+        for (auto& item : gateStats) {
+            delete item.second.windowBytesVec;
+            delete item.second.unusedTimeVec;
+            delete item.second.missedFramesVec;
+            delete item.second.depthAtOpenVec;
+        }
     }
 
   protected:
@@ -94,13 +206,21 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
     virtual void initialize(int stage) override {
         auto systemModule = getSimulation()->getSystemModule();
         if (stage == INITSTAGE_LOCAL) {
+            recordGateWindows = par("recordGateWindows");
+            std::string traceFile = par("traceFile").stdstringValue();
+            if (!traceFile.empty()) {
+                int blockRecords = par("traceBlockRecords");
+                if (blockRecords <= 0)
+                    throw cRuntimeError("traceBlockRecords must be > 0");
+                if (!trace.open(traceFile, blockRecords, SimTime::getScaleExp()))
+                    throw cRuntimeError("Cannot open trace file '%s'", traceFile.c_str());
+            }
             systemModule->subscribe(packetSentSignal, this);
             systemModule->subscribe(packetReceivedSignal, this);
-            systemModule->subscribe(gateStateChangedSignal, this);
-            discoverAndSubscribe(systemModule);
         }
         else if (stage == INITSTAGE_LAST) {
-            discoverAndSubscribe(systemModule);
+            // 所有门控已完成初始化，此时一次性登记并从当前状态开始统计窗口
+            discoverTsnSwitches(systemModule);
             EV_INFO << "TSNConfigSummary: tsn_switches=" << tsnSwitchCount
                     << ", shaping_enabled=" << tsnShapingEnabledCount
                     << ", transmissionGate_modules=" << transmissionGateModuleCount << endl;
@@ -108,6 +228,13 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
     }
 
     virtual void finish() override {
+        if (trace.isOpen()) {
+            EV_INFO << "PacketTrace: file=" << par("traceFile").stdstringValue()
+                    << ", records=" << trace.getRecordCount() << endl;
+            recordScalar("traceRecords", trace.getRecordCount());
+            trace.close();
+        }
+
         EV_INFO << "\n========== Traffic KPI Summary ==========" << endl;
 
         std::vector<std::string> order = {"SV", "GOOSE", "VoIP", "Video", "OM_Data", "Other", "ALL"};
@@ -143,25 +270,38 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
             << ", shaping_enabled=" << tsnShapingEnabledCount
             << ", transmissionGate_modules=" << transmissionGateModuleCount << endl;
         if (gateStats.empty()) {
-            EV_INFO << "(no transmissionGate state events observed)" << endl;
-            EV_INFO << "Possible reasons: running NoTSN config, hasEgressTrafficShaping=false, or transmissionGate path filter mismatch." << endl;
+            EV_INFO << "(no transmissionGate modules registered)" << endl;
+            EV_INFO << "Possible reasons: running NoTSN config, hasEgressTrafficShaping=false, or no eth[*].macLayer.queue.transmissionGate[*] in TSN switches." << endl;
         }
-        for (const auto& item : gateStats) {
-            const auto& gatePath = item.first;
-            auto gate = item.second;
+        for (auto& item : gateStats) {
+            auto& gate = item.second;
 
             if (gate.initialized) {
                 simtime_t endTime = simTime();
-                if (gate.currentOpen && endTime > gate.lastChangeTime)
+                if (gate.currentOpen && endTime > gate.lastChangeTime) {
                     gate.openTime += endTime - gate.lastChangeTime;
+                    closeWindow(gate, endTime - gate.lastChangeTime);
+                }
+                gate.currentOpen = false;
+                gate.lastChangeTime = endTime;
             }
 
             double openRatio = simTime() > SIMTIME_ZERO ? (100.0 * gate.openTime.dbl() / simTime().dbl()) : 0.0;
+            double unusedPct = gate.openTime > SIMTIME_ZERO ? (100.0 * gate.unusedOpenTime.dbl() / gate.openTime.dbl()) : 0.0;
+            double avgWindowBytes = gate.windows > 0 ? (1.0 * gate.txBytes / gate.windows) : 0.0;
+            double avgDepthAtOpen = gate.windows > 0 ? (1.0 * gate.depthAtOpenSum / gate.windows) : 0.0;
         EV_INFO << "GateKPI: "
-            << "gate=" << gatePath
+            << "gate=" << gate.path
             << ", open_events=" << gate.openEvents
             << ", close_events=" << gate.closeEvents
             << ", open_ratio_pct=" << openRatio
+            << ", windows=" << gate.windows
+            << ", tx_bytes=" << gate.txBytes
+            << ", avg_window_bytes=" << avgWindowBytes
+            << ", unused_open_pct=" << (gate.bitrate > 0 ? std::to_string(unusedPct) : std::string("n/a"))
+            << ", missed_frames=" << gate.missedFrames
+            << ", avg_depth_at_open=" << avgDepthAtOpen
+            << ", max_depth_at_open=" << gate.maxDepthAtOpen
             << endl;
         }
         EV_INFO << "==============================================\n" << endl;
@@ -172,6 +312,19 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
         if (packet == nullptr)
             return;
 
+        if (signalID == packetPulledSignal) {
+            // 门控窗口内从 queue[i] 取出的帧计入该窗口的发送字节与占用时间
+            auto it = gateByQueue.find(source->getId());
+            if (it == gateByQueue.end())
+                return;
+            auto& gate = gateStats[it->second];
+            long bytes = B(packet->getTotalLength()).get();
+            gate.windowBytes += bytes;
+            if (gate.bitrate > 0)
+                gate.windowBusyTime += (bytes + ETHERNET_WIRE_OVERHEAD_BYTES) * 8 / gate.bitrate;
+            return;
+        }
+
         std::string sourcePath = source->getFullPath();
         if (sourcePath.find(".app[") == std::string::npos)
             return;
@@ -181,38 +334,68 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
         if (signalID == packetSentSignal) {
             stats[flow].sent++;
             stats["ALL"].sent++;
+            if (trace.isOpen())
+                writeTraceRecord(source, packet, flow, PacketTraceWriter::SENT);
         }
         else if (signalID == packetReceivedSignal) {
             updateReceiveStats(stats[flow], packet);
             updateReceiveStats(stats["ALL"], packet);
+            if (trace.isOpen())
+                writeTraceRecord(source, packet, flow, PacketTraceWriter::RECEIVED);
+        }
+    }
+
+    static uint32_t ipv4Int(const L3Address& address) {
+        return address.getType() == L3Address::IPv4 ? address.toIpv4().getInt() : 0;
+    }
+
+    void writeTraceRecord(cComponent *source, Packet *packet, const std::string& flow, PacketTraceWriter::Event event) {
+        int64_t delay = -1;
+        uint32_t src = 0;
+        uint32_t dst = 0;
+        if (event == PacketTraceWriter::RECEIVED) {
+            delay = (simTime() - sentTimeOf(packet)).raw();
+            // 发送时报文尚未经过 UdpSocket，只有接收事件带有 L3 地址指示
+            if (auto addressInd = packet->findTag<L3AddressInd>()) {
+                src = ipv4Int(addressInd->getSrcAddress());
+                dst = ipv4Int(addressInd->getDestAddress());
+            }
         }
+        trace.write(simTime().raw(), delay, packet->getTreeId(), src, dst, source->getId(),
+                    B(packet->getTotalLength()).get(), event, PacketTraceWriter::flowCode(flow));
+    }
+
+    static simtime_t sentTimeOf(Packet *packet) {
+        simtime_t sentTime = packet->getTimestamp();
+        if (sentTime == SIMTIME_ZERO)
+            sentTime = packet->getCreationTime();
+        return sentTime;
     }
 
     virtual void receiveSignal(cComponent *source, simsignal_t signalID, bool value, cObject *details) override {
         if (signalID != gateStateChangedSignal)
             return;
 
-        std::string sourcePath = source->getFullPath();
-        std::string nedType = source->getNedTypeName();
-        if (nedType.find("PeriodicGate") == std::string::npos)
+        auto it = gateStats.find(source->getId());
+        if (it == gateStats.end())
             return;
 
-        auto& gate = gateStats[sourcePath];
+        auto& gate = it->second;
         simtime_t now = simTime();
-        if (!gate.initialized) {
-            gate.initialized = true;
-            gate.currentOpen = value;
-            gate.lastChangeTime = now;
+        if (value == gate.currentOpen)
             return;
-        }
 
         if (gate.currentOpen && now > gate.lastChangeTime)
             gate.openTime += now - gate.lastChangeTime;
 
-        if (value)
+        if (value) {
             gate.openEvents++;
-        else
+            openWindow(gate);
+        }
+        else {
             gate.closeEvents++;
+            closeWindow(gate, now - gate.lastChangeTime);
+        }
 
         gate.currentOpen = value;
         gate.lastChangeTime = now;
@@ -236,10 +419,7 @@ class TrafficKpiReporter : public cSimpleModule, public cListener
     void updateReceiveStats(FlowStats& flowStats, Packet *packet) {
         flowStats.received++;
 
-        simtime_t sentTime = packet->getTimestamp();
-        if (sentTime == SIMTIME_ZERO)
-            sentTime = packet->getCreationTime();
-        simtime_t delay = simTime() - sentTime;
+        simtime_t delay = simTime() - sentTimeOf(packet);
 
         flowStats.delaySamples++;
         flowStats.delaySum += delay.dbl();
@@ -0,0 +1,317 @@
+#include <omnetpp.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "inet/common/INETDefs.h"
+#include "inet/common/InitStages.h"
+#include "inet/common/packet/Packet.h"
+#include "inet/networklayer/common/L3AddressTag_m.h"
+#include "inet/transportlayer/common/L4PortTag_m.h"
+#include "inet/transportlayer/contract/udp/UdpSocket.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+// VideoReassemblySinkApp：
+//  - 与 VideoFragmentApp 配对的视频帧重组接收端（替代 UdpSink），从报文名 "<name> frame=<n> frag=<i>/<N>"
+//    读取帧序号与分片序号，按 (源地址:源端口, 帧序号) 跟踪每帧的分片到达位图；
+//  - 每个未完成帧只保存 ceil(N/64) 个 64 位字的位图与少量时间戳，同时打开的帧数不超过 maxOpenFrames，
+//    超出时淘汰最早开始的帧（单独计为 evicted，结果未知，不计入完成率）；
+//    首个分片到达后超过 frameTimeout 仍未收齐的帧判为不完整，仿真结束时仍缺分片的帧同样计为不完整（单独报告为 pending）；
+//  - 帧时延：最后一个分片到达时刻 - 帧发送时刻（分片时间戳）；帧展宽：首片到末片的到达间隔；
+//    分片间隔：同一帧相邻两个分片的到达间隔，反映 GCL 窗口对视频分片的切割。
+class VideoReassemblySinkApp : public cSimpleModule, public UdpSocket::ICallback
+{
+  private:
+    struct FrameKey {
+        uint64_t source;   // IPv4 地址 << 16 | UDP 源端口
+        long frame;
+        bool operator==(const FrameKey& other) const { return source == other.source && frame == other.frame; }
+    };
+    struct FrameKeyHash {
+        size_t operator()(const FrameKey& key) const {
+            return std::hash<uint64_t>()(key.source * 0x9E3779B97F4A7C15ULL ^ (uint64_t)key.frame);
+        }
+    };
+    struct FrameState {
+        std::vector<uint64_t> bitmap;
+        int numFrags = 0;
+        int received = 0;
+        simtime_t sentTime;
+        simtime_t firstArrival;
+        simtime_t lastArrival;
+    };
+
+    UdpSocket socket;
+    int localPort = -1;
+    simtime_t frameTimeout;
+    int maxOpenFrames = 0;
+    int closedHistory = 0;
+
+    simsignal_t packetReceivedSignal = cComponent::registerSignal("packetReceived");
+
+    std::unordered_map<FrameKey, FrameState, FrameKeyHash> openFrames;
+    // 按开始时间排序的打开帧（用于超时/容量淘汰；帧完成后条目失效，弹出时跳过）
+    std::deque<std::pair<simtime_t, FrameKey>> openOrder;
+    // 最近已关闭（完成或淘汰）的帧，迟到的分片据此丢弃而不会重新打开该帧；容量固定
+    std::unordered_set<FrameKey, FrameKeyHash> closedFrames;
+    std::deque<FrameKey> closedOrder;
+
+    long fragmentCount = 0;
+    long unparsedFragments = 0;
+    long duplicateFragments = 0;
+    long lateFragments = 0;
+    long outOfOrderFragments = 0;
+    long framesCompleted = 0;
+    long framesTimedOut = 0;
+    long framesEvicted = 0;
+
+    std::vector<double> frameLatencies;
+    std::vector<double> frameSpreads;
+    cOutVector frameLatencyVec;
+    cOutVector frameSpreadVec;
+    cHistogram fragmentGapHist;
+    cHistogram missingFragmentsHist;
+
+    static bool parseFragmentName(const char *name, long& frame, int& fragIndex, int& numFrags) {
+        const char *framePos = std::strstr(name, " frame=");
+        const char *fragPos = std::strstr(name, " frag=");
+        if (framePos == nullptr || fragPos == nullptr)
+            return false;
+        char *end;
+        frame = std::strtol(framePos + 7, &end, 10);
+        fragIndex = (int)std::strtol(fragPos + 6, &end, 10);
+        if (*end != '/')
+            return false;
+        numFrags = (int)std::strtol(end + 1, &end, 10);
+        return frame >= 0 && numFrags > 0 && fragIndex >= 1 && fragIndex <= numFrags;
+    }
+
+    void rememberClosed(const FrameKey& key) {
+        closedFrames.insert(key);
+        closedOrder.push_back(key);
+        if ((int)closedOrder.size() > closedHistory) {
+            closedFrames.erase(closedOrder.front());
+            closedOrder.pop_front();
+        }
+    }
+
+    // 关闭未收齐的帧：超时帧计为不完整并记录缺失分片数；容量淘汰的帧可能仍在到达，只计入 evicted
+    void closeIncomplete(std::unordered_map<FrameKey, FrameState, FrameKeyHash>::iterator it, bool timedOut) {
+        if (timedOut) {
+            missingFragmentsHist.collect(it->second.numFrags - it->second.received);
+            framesTimedOut++;
+        }
+        else
+            framesEvicted++;
+        rememberClosed(it->first);
+        openFrames.erase(it);
+    }
+
+    // 淘汰超时帧；打开帧数超过上限时淘汰最早开始的帧
+    void evictFrames() {
+        while (!openOrder.empty()) {
+            const auto& front = openOrder.front();
+            auto it = openFrames.find(front.second);
+            if (it == openFrames.end() || it->second.firstArrival != front.first) {
+                openOrder.pop_front();
+                continue;
+            }
+            bool timedOut = simTime() - front.first > frameTimeout;
+            if (!timedOut && (int)openFrames.size() <= maxOpenFrames)
+                break;
+            openOrder.pop_front();
+            closeIncomplete(it, timedOut);
+        }
+    }
+
+    static double percentile(std::vector<double>& values, double q) {
+        if (values.empty())
+            return 0;
+        size_t index = std::min(values.size() - 1, (size_t)(q * (values.size() - 1) + 0.5));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+  protected:
+    virtual int numInitStages() const override { return NUM_INIT_STAGES; }
+
+    virtual void initialize(int stage) override {
+        cSimpleModule::initialize(stage);
+        if (stage == INITSTAGE_LOCAL) {
+            localPort = par("localPort");
+            frameTimeout = par("frameTimeout");
+            maxOpenFrames = par("maxOpenFrames");
+            if (maxOpenFrames <= 0)
+                throw cRuntimeError("maxOpenFrames must be > 0");
+            closedHistory = 4 * maxOpenFrames;
+            frameLatencyVec.setName("frameLatency");
+            frameSpreadVec.setName("frameSpread");
+            fragmentGapHist.setName("fragmentGap");
+            missingFragmentsHist.setName("missingFragments");
+        }
+        else if (stage == INITSTAGE_APPLICATION_LAYER) {
+            socket.setOutputGate(gate("socketOut"));
+            socket.setCallback(this);
+            socket.bind(localPort);
+        }
+    }
+
+    virtual void handleMessage(cMessage *msg) override {
+        if (socket.belongsToSocket(msg))
+            socket.processMessage(msg);
+        else
+            delete msg;
+    }
+
+    virtual void socketDataArrived(UdpSocket *socket, Packet *packet) override {
+        fragmentCount++;
+        emit(packetReceivedSignal, packet);
+
+        long frame;
+        int fragIndex, numFrags;
+        if (!parseFragmentName(packet->getName(), frame, fragIndex, numFrags)) {
+            unparsedFragments++;
+            delete packet;
+            return;
+        }
+        FrameKey key;
+        auto addressInd = packet->getTag<L3AddressInd>();
+        uint64_t srcAddress = addressInd->getSrcAddress().getType() == L3Address::IPv4 ? addressInd->getSrcAddress().toIpv4().getInt() : 0;
+        key.source = (srcAddress << 16) | (uint16_t)packet->getTag<L4PortInd>()->getSrcPort();
+        key.frame = frame;
+        simtime_t sentTime = packet->getTimestamp();
+        delete packet;
+
+        simtime_t now = simTime();
+        evictFrames();
+        if (closedFrames.count(key)) {
+            lateFragments++;
+            return;
+        }
+
+        auto it = openFrames.find(key);
+        if (it == openFrames.end()) {
+            it = openFrames.emplace(key, FrameState()).first;
+            auto& state = it->second;
+            state.numFrags = numFrags;
+            state.bitmap.assign((numFrags + 63) / 64, 0);
+            state.sentTime = sentTime;
+            state.firstArrival = now;
+            state.lastArrival = now;
+            openOrder.push_back({now, key});
+        }
+
+        auto& state = it->second;
+        int bit = fragIndex - 1;
+        uint64_t mask = 1ULL << (bit % 64);
+        uint64_t& word = state.bitmap[bit / 64];
+        if (word & mask) {
+            duplicateFragments++;
+            return;
+        }
+        if (state.received > 0) {
+            fragmentGapHist.collect(now - state.lastArrival);
+            state.lastArrival = now;
+        }
+        // 分片按序号连续发送，前一个分片未到而后一个先到即为乱序（或前序分片丢失）
+        if (bit > 0 && !(state.bitmap[(bit - 1) / 64] & (1ULL << ((bit - 1) % 64))))
+            outOfOrderFragments++;
+        word |= mask;
+        state.received++;
+
+        if (state.received == state.numFrags) {
+            double latency = (now - state.sentTime).dbl();
+            double spread = (now - state.firstArrival).dbl();
+            frameLatencies.push_back(latency);
+            frameSpreads.push_back(spread);
+            frameLatencyVec.record(latency);
+            frameSpreadVec.record(spread);
+            framesCompleted++;
+            rememberClosed(key);
+            openFrames.erase(it);
+        }
+        else if ((int)openFrames.size() > maxOpenFrames)
+            evictFrames();
+    }
+
+    virtual void socketErrorArrived(UdpSocket *socket, Indication *indication) override {
+        delete indication;
+    }
+
+    virtual void socketClosed(UdpSocket *socket) override {}
+
+    virtual void finish() override {
+        // 仿真结束时仍在接收中的帧：已超时的计为超时；其余（仍缺分片）计为 pending，
+        // 同样算作不完整并计入完成率分母。容量淘汰的帧结果未知，单独报告，不计入完成率
+        long framesPending = 0;
+        for (auto it = openFrames.begin(); it != openFrames.end(); ) {
+            auto next = std::next(it);
+            if (simTime() - it->second.firstArrival > frameTimeout)
+                closeIncomplete(it, true);
+            else {
+                missingFragmentsHist.collect(it->second.numFrags - it->second.received);
+                framesPending++;
+            }
+            it = next;
+        }
+        long framesIncomplete = framesTimedOut + framesPending;
+        long framesJudged = framesCompleted + framesIncomplete;
+        double completionRate = framesJudged > 0 ? 100.0 * framesCompleted / framesJudged : 0.0;
+        double latencyP50 = percentile(frameLatencies, 0.50);
+        double latencyP95 = percentile(frameLatencies, 0.95);
+        double latencyP99 = percentile(frameLatencies, 0.99);
+        double latencyMax = frameLatencies.empty() ? 0 : *std::max_element(frameLatencies.begin(), frameLatencies.end());
+        double spreadP50 = percentile(frameSpreads, 0.50);
+        double spreadP95 = percentile(frameSpreads, 0.95);
+        double spreadP99 = percentile(frameSpreads, 0.99);
+
+        EV_INFO << "VideoKPI: sink=" << getFullPath()
+                << ", fragments=" << fragmentCount
+                << ", frames_completed=" << framesCompleted
+                << ", frames_incomplete=" << framesIncomplete
+                << ", frames_timed_out=" << framesTimedOut
+                << ", frames_pending=" << framesPending
+                << ", frames_evicted=" << framesEvicted
+                << ", completion_pct=" << completionRate
+                << ", latency_p50_ms=" << latencyP50 * 1000
+                << ", latency_p95_ms=" << latencyP95 * 1000
+                << ", latency_p99_ms=" << latencyP99 * 1000
+                << ", latency_max_ms=" << latencyMax * 1000
+                << ", spread_p95_ms=" << spreadP95 * 1000
+                << ", gap_mean_us=" << (fragmentGapHist.getCount() > 0 ? fragmentGapHist.getMean() * 1e6 : 0.0)
+                << ", gap_max_us=" << (fragmentGapHist.getCount() > 0 ? fragmentGapHist.getMax() * 1e6 : 0.0)
+                << ", out_of_order=" << outOfOrderFragments
+                << ", duplicates=" << duplicateFragments
+                << ", late=" << lateFragments << endl;
+
+        recordScalar("fragmentCount", fragmentCount);
+        recordScalar("unparsedFragments", unparsedFragments);
+        recordScalar("duplicateFragments", duplicateFragments);
+        recordScalar("lateFragments", lateFragments);
+        recordScalar("outOfOrderFragments", outOfOrderFragments);
+        recordScalar("framesCompleted", framesCompleted);
+        recordScalar("framesIncomplete", framesIncomplete);
+        recordScalar("framesTimedOut", framesTimedOut);
+        recordScalar("framesEvicted", framesEvicted);
+        recordScalar("framesPending", framesPending);
+        recordScalar("frameCompletionRate", completionRate);
+        recordScalar("frameLatencyP50", latencyP50, "s");
+        recordScalar("frameLatencyP95", latencyP95, "s");
+        recordScalar("frameLatencyP99", latencyP99, "s");
+        recordScalar("frameLatencyMax", latencyMax, "s");
+        recordScalar("frameSpreadP50", spreadP50, "s");
+        recordScalar("frameSpreadP95", spreadP95, "s");
+        recordScalar("frameSpreadP99", spreadP99, "s");
+        recordStatistic(&fragmentGapHist, "s");
+        recordStatistic(&missingFragmentsHist);
+    }
+};
+
+Define_Module(VideoReassemblySinkApp);
@@ -0,0 +1,14 @@
+#ifndef __SMARTSUBSTATION_BENCHALLOCCOUNTER_H
+#define __SMARTSUBSTATION_BENCHALLOCCOUNTER_H
+
+// 微基准的堆分配计数入口：
+//  - make bench 生成的 SmartSubstation_bench 可执行文件额外链接 tools/appbench/AllocCounter.cc，
+//    其替换全局 operator new 并在静态初始化时设置该函数指针；
+//  - 普通仿真程序中该指针为空，benchAllocations() 返回 0，基准模块只报告耗时。
+extern unsigned long long (*benchAllocationCounter)();
+
+inline unsigned long long benchAllocations() {
+    return benchAllocationCounter != nullptr ? benchAllocationCounter() : 0;
+}
+
+#endif
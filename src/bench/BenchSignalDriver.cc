@@ -0,0 +1,110 @@
+#include <omnetpp.h>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "inet/common/INETDefs.h"
+#include "inet/common/packet/Packet.h"
+#include "inet/common/Units.h"
+#include "inet/common/packet/chunk/ByteCountChunk.h"
+#include "BenchAllocCounter.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+// BenchSignalEmitter：占位的应用模块（网络中命名为 app[i]），仅作为 packetSent/packetReceived 信号的发出者，
+// 使 TrafficKpiReporter 按真实应用路径（包含 ".app["）处理这些信号。
+class BenchSignalEmitter : public cSimpleModule
+{
+  protected:
+    virtual void handleMessage(cMessage *msg) override { delete msg; }
+};
+
+Define_Module(BenchSignalEmitter);
+
+// BenchSignalDriver：
+//  - 每个 sendInterval 依次让每个 app[i] 发出一次 packetSent 与一次 packetReceived 信号；
+//  - 报文按 app 序号轮流使用 SV/GOOSE/VoIP/Video/OM_Data 的报文名，时间戳早于当前时刻 transitDelay，
+//    报文在初始化时预先创建并重复使用，驱动本身不产生分配；
+//  - 信号同步投递给订阅者，因此 emit() 前后的墙钟时间与堆分配即为 TrafficKpiReporter::receiveSignal
+//    （含信号分发）的开销，按每个信号计为一次操作。
+class BenchSignalDriver : public cSimpleModule
+{
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    simsignal_t packetSentSignal = cComponent::registerSignal("packetSent");
+    simsignal_t packetReceivedSignal = cComponent::registerSignal("packetReceived");
+    simtime_t sendInterval;
+    simtime_t warmupTime;
+    simtime_t transitDelay;
+    cMessage *timer = nullptr;
+    std::vector<cModule *> emitters;
+    std::vector<Packet *> packets;
+
+    double emitSeconds = 0;
+    unsigned long long emitAllocations = 0;
+    long ops = 0;
+
+  protected:
+    virtual void initialize() override {
+        static const char *const names[] = {"SV", "GOOSE:TripCommand", "VoIP_Stream", "Video_Stream", "OM_Data_Burst_A"};
+        sendInterval = par("sendInterval");
+        warmupTime = par("warmupTime");
+        transitDelay = par("transitDelay");
+        int numFlows = getParentModule()->par("numFlows");
+        for (int i = 0; i < numFlows; i++) {
+            emitters.push_back(getParentModule()->getSubmodule("app", i));
+            auto packet = new Packet(names[i % 5]);
+            packet->insertAtBack(makeShared<ByteCountChunk>(B(par("messageLength").intValue())));
+            packets.push_back(packet);
+        }
+        timer = new cMessage("emitTimer");
+        scheduleAt(sendInterval, timer);
+    }
+
+    virtual void handleMessage(cMessage *msg) override {
+        bool measuring = simTime() >= warmupTime;
+        for (size_t i = 0; i < emitters.size(); i++)
+            packets[i]->setTimestamp(simTime() - transitDelay);
+
+        Clock::time_point start = Clock::now();
+        unsigned long long startAllocations = benchAllocations();
+        for (size_t i = 0; i < emitters.size(); i++) {
+            emitters[i]->emit(packetSentSignal, packets[i]);
+            emitters[i]->emit(packetReceivedSignal, packets[i]);
+        }
+        if (measuring) {
+            emitSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            emitAllocations += benchAllocations() - startAllocations;
+            ops += 2 * emitters.size();
+        }
+        scheduleAt(simTime() + sendInterval, timer);
+    }
+
+    virtual void finish() override {
+        cancelAndDelete(timer);
+        timer = nullptr;
+        for (auto packet : packets)
+            delete packet;
+        packets.clear();
+        double nsPerOp = ops > 0 ? 1e9 * emitSeconds / ops : 0.0;
+        double allocationsPerOp = ops > 0 ? (double)emitAllocations / ops : 0.0;
+        double opsPerSecond = emitSeconds > 0 ? ops / emitSeconds : 0.0;
+        // Cmdenv 快速模式不输出 EV 日志，基准结果直接写到标准输出
+        std::cout << "BenchKPI: app=TrafficKpiReporter::receiveSignal"
+                  << ", label=" << par("label").stdstringValue()
+                  << ", flows=" << emitters.size()
+                  << ", ops=" << ops
+                  << ", ns_per_op=" << nsPerOp
+                  << ", allocs_per_op=" << (benchAllocationCounter != nullptr ? std::to_string(allocationsPerOp) : std::string("n/a"))
+                  << ", ops_per_sec=" << opsPerSecond
+                  << std::endl;
+        recordScalar("benchOps", ops);
+        recordScalar("benchNsPerOp", nsPerOp);
+        recordScalar("benchAllocsPerOp", allocationsPerOp);
+        recordScalar("benchOpsPerSecond", opsPerSecond);
+    }
+};
+
+Define_Module(BenchSignalDriver);
@@ -0,0 +1,183 @@
+#include <omnetpp.h>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "inet/common/INETDefs.h"
+#include "inet/common/Message.h"
+#include "inet/common/packet/Packet.h"
+#include "inet/common/Units.h"
+#include "inet/common/packet/chunk/ByteCountChunk.h"
+#include "inet/common/packet/chunk/BytesChunk.h"
+#include "inet/common/socket/SocketTag_m.h"
+#include "inet/networklayer/common/L3AddressTag_m.h"
+#include "inet/transportlayer/common/L4PortTag_m.h"
+#include "inet/transportlayer/contract/udp/UdpControlInfo_m.h"
+#include "BenchAllocCounter.h"
+
+using namespace omnetpp;
+using namespace inet;
+
+unsigned long long (*benchAllocationCounter)() = nullptr;
+
+// BenchUdpStandIn：
+//  - 微基准网络中替代 INET Udp 模块的最小桩，直接与被测应用的 socketOut/socketIn 相连；
+//  - 记录应用 bind 命令中的 端口 -> socketId，其余 socket 命令与应用发出的报文直接丢弃；
+//  - rx 模式下按 injectInterval 向应用注入带 SocketInd/L3AddressInd/L4PortInd 的合成 SV 报文，
+//    负载格式与 SvGeneratorApp 相同（slot/seq/current），远端流可落后 remoteLagSlots 个时隙；
+//  - 网络中只有本模块与被测应用两个模块，因此两次进入本模块之间的墙钟时间与堆分配
+//    即为被测应用（含调度器投递）的开销，据此计算每次操作的 ns/op、allocs/op 与吞吐。
+//    tx 模式以应用的一次发送事件（同一仿真时刻到达的一批报文）为一次操作，rx 模式以注入的每个报文为一次操作。
+class BenchUdpStandIn : public cSimpleModule
+{
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    bool rxMode = false;
+    simtime_t warmupTime;
+    simtime_t injectInterval;
+    int injectLocalPort = -1;
+    int injectRemotePort = -1;
+    int remoteLagSlots = 0;
+    int injectMessageLength = 0;
+    cMessage *injectTimer = nullptr;
+    long long slot = 0;
+
+    // 应用 bind 的本地端口 -> socketId
+    std::map<int, int> socketByPort;
+
+    // 测量状态
+    bool measuring = false;
+    bool hasLastExit = false;
+    Clock::time_point lastExit;
+    unsigned long long lastExitAllocations = 0;
+    double outsideSeconds = 0;
+    unsigned long long outsideAllocations = 0;
+    long ops = 0;
+    long appPackets = 0;
+    long appBytes = 0;
+    simtime_t lastArrivalTime = -1;
+
+    Packet *createSample(int port, long long sampleSlot) {
+        std::string payload = "slot=" + std::to_string(sampleSlot)
+                            + ";seq=" + std::to_string(sampleSlot)
+                            + ";current=" + std::to_string(100.0 + (sampleSlot % 7) * 0.1);
+        std::vector<uint8_t> payloadBytes(payload.begin(), payload.end());
+        auto packet = new Packet("SV");
+        packet->setTimestamp(simTime());
+        packet->insertAtBack(makeShared<BytesChunk>(payloadBytes));
+        int paddingBytes = injectMessageLength - static_cast<int>(payloadBytes.size());
+        if (paddingBytes > 0)
+            packet->insertAtBack(makeShared<ByteCountChunk>(B(paddingBytes)));
+        packet->setKind(UDP_I_DATA);
+        packet->addTag<SocketInd>()->setSocketId(socketByPort.at(port));
+        auto addressInd = packet->addTag<L3AddressInd>();
+        addressInd->setSrcAddress(Ipv4Address(10, 0, 0, 1));
+        addressInd->setDestAddress(Ipv4Address(10, 0, 0, 2));
+        auto portInd = packet->addTag<L4PortInd>();
+        portInd->setSrcPort(1024);
+        portInd->setDestPort(port);
+        return packet;
+    }
+
+    void injectSamples() {
+        if (injectLocalPort >= 0 && socketByPort.count(injectLocalPort)) {
+            send(createSample(injectLocalPort, slot), "appOut");
+            if (measuring)
+                ops++;
+        }
+        long long remoteSlot = slot - remoteLagSlots;
+        if (injectRemotePort >= 0 && remoteSlot >= 0 && socketByPort.count(injectRemotePort)) {
+            send(createSample(injectRemotePort, remoteSlot), "appOut");
+            if (measuring)
+                ops++;
+        }
+        slot++;
+    }
+
+  protected:
+    virtual void initialize() override {
+        std::string opMode = par("opMode").stdstringValue();
+        if (opMode != "tx" && opMode != "rx")
+            throw cRuntimeError("Unknown opMode '%s', expected \"tx\" or \"rx\"", opMode.c_str());
+        rxMode = opMode == "rx";
+        warmupTime = par("warmupTime");
+        injectInterval = par("injectInterval");
+        injectLocalPort = par("injectLocalPort");
+        injectRemotePort = par("injectRemotePort");
+        remoteLagSlots = par("remoteLagSlots");
+        injectMessageLength = par("injectMessageLength");
+        if (rxMode) {
+            injectTimer = new cMessage("injectTimer");
+            scheduleAt(injectInterval, injectTimer);
+        }
+    }
+
+    virtual void handleMessage(cMessage *msg) override {
+        Clock::time_point enter = Clock::now();
+        unsigned long long enterAllocations = benchAllocations();
+        // 上次离开本模块到这次进入之间的时间与分配都发生在被测应用中
+        bool accounted = measuring;
+        if (measuring && hasLastExit) {
+            outsideSeconds += std::chrono::duration<double>(enter - lastExit).count();
+            outsideAllocations += enterAllocations - lastExitAllocations;
+        }
+        else if (simTime() >= warmupTime)
+            measuring = true;
+
+        if (msg == injectTimer) {
+            injectSamples();
+            scheduleAt(simTime() + injectInterval, injectTimer);
+        }
+        else if (auto packet = dynamic_cast<Packet *>(msg)) {
+            if (accounted) {
+                appPackets++;
+                appBytes += B(packet->getTotalLength()).get();
+                if (!rxMode && simTime() != lastArrivalTime)
+                    ops++;
+            }
+            lastArrivalTime = simTime();
+            delete packet;
+        }
+        else {
+            if (msg->getKind() == UDP_C_BIND) {
+                auto command = check_and_cast<UdpBindCommand *>(msg->getControlInfo());
+                int socketId = check_and_cast<ITaggedObject *>(msg)->getTags().getTag<SocketReq>()->getSocketId();
+                socketByPort[command->getLocalPort()] = socketId;
+            }
+            delete msg;
+        }
+
+        lastExit = Clock::now();
+        lastExitAllocations = benchAllocations();
+        hasLastExit = true;
+    }
+
+    virtual void finish() override {
+        cancelAndDelete(injectTimer);
+        injectTimer = nullptr;
+        double nsPerOp = ops > 0 ? 1e9 * outsideSeconds / ops : 0.0;
+        double allocationsPerOp = ops > 0 ? (double)outsideAllocations / ops : 0.0;
+        double opsPerSecond = outsideSeconds > 0 ? ops / outsideSeconds : 0.0;
+        double packetsPerOp = ops > 0 ? (double)appPackets / ops : 0.0;
+        // Cmdenv 快速模式不输出 EV 日志，基准结果直接写到标准输出
+        std::cout << "BenchKPI: app=" << getParentModule()->getSubmodule("app")->getNedTypeName()
+                  << ", label=" << par("label").stdstringValue()
+                  << ", mode=" << (rxMode ? "rx" : "tx")
+                  << ", ops=" << ops
+                  << ", ns_per_op=" << nsPerOp
+                  << ", allocs_per_op=" << (benchAllocationCounter != nullptr ? std::to_string(allocationsPerOp) : std::string("n/a"))
+                  << ", ops_per_sec=" << opsPerSecond
+                  << ", app_packets_per_op=" << packetsPerOp
+                  << std::endl;
+        recordScalar("benchOps", ops);
+        recordScalar("benchNsPerOp", nsPerOp);
+        recordScalar("benchAllocsPerOp", allocationsPerOp);
+        recordScalar("benchOpsPerSecond", opsPerSecond);
+        recordScalar("benchAppPackets", appPackets);
+        recordScalar("benchAppBytes", appBytes);
+    }
+};
+
+Define_Module(BenchUdpStandIn);
@@ -0,0 +1,274 @@
+#include <omnetpp.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../apps/SvSampleGenerator.h"
+#include "../apps/DifferentialEngine.h"
+#include "SilUdpLink.h"
+
+using namespace omnetpp;
+
+// SilProtectionApp：
+//  - 软件在环（SIL）模式下的差动保护：与 DifferentialProtectionApp 共用 DifferentialEngine（时隙对齐与阈值判决），
+//    但从本机真实 UDP socket（本地/远端两个端口）接收 SV，而不是从 INET 网络栈；
+//  - 须在 cRealTimeScheduler 下运行：每隔 pollInterval 的轮询事件排空两个非阻塞 socket，逐个数据报解析并判决；
+//  - 墙钟统计（单调时钟）：
+//      processingLatency  取出数据报 -> 判决完成（单样本处理耗时）
+//      endToEndLatency    发送端 txns -> 判决完成（含内核回环、轮询等待与处理）
+//      pollLateness       轮询事件实际执行时刻相对计划时刻的滞后（调度滞后）
+//      missedDeadlines    endToEndLatency 超过 deadline 的样本数
+//    另按 seq 统计各流的丢失/乱序/重复，以及判决动作次数；结果输出 SilKPI 行并记录标量/向量/直方图。
+class SilProtectionApp : public cSimpleModule
+{
+  private:
+    SilUdpLink socketLocal;
+    SilUdpLink socketRemote;
+    DifferentialEngine engine;
+    SilWallClock wallClock;
+    cMessage *pollTimer = nullptr;
+    simtime_t pollInterval;
+    simtime_t warmupTime;
+    long long deadlineNs = 0;
+    std::vector<char> buffer;
+
+    // 按 seq 跟踪一条 SV 流：expected 为期望的下一个 seq（-1 表示尚未收到），
+    // missing 按 seq % SEQ_WINDOW 标记 [expected - SEQ_WINDOW, expected) 内仍未到达的序号
+    static const int SEQ_WINDOW = 4096;
+    struct SeqTracker {
+        long long expected = -1;
+        std::vector<bool> missing = std::vector<bool>(SEQ_WINDOW, false);
+    };
+    SeqTracker seqLocal;
+    SeqTracker seqRemote;
+
+    long localRxCount = 0;
+    long remoteRxCount = 0;
+    long malformedCount = 0;
+    long lostCount = 0;
+    long reorderedCount = 0;
+    long duplicateCount = 0;
+    long missedDeadlineCount = 0;
+    long tripCount = 0;
+    long pollCount = 0;
+    long maxBatch = 0;
+
+    // 预热期之后的样本，用于分位数（纳秒）
+    std::vector<double> processingNs;
+    std::vector<double> endToEndNs;
+    std::vector<double> pollLatenessNs;
+    std::vector<double> tripLatencyNs;
+
+    cOutVector processingLatencyVec;
+    cOutVector endToEndLatencyVec;
+    cOutVector pollLatenessVec;
+    cHistogram processingLatencyHist;
+    cHistogram endToEndLatencyHist;
+    cHistogram pollLatenessHist;
+
+    static double percentile(std::vector<double>& values, double q) {
+        if (values.empty())
+            return 0;
+        size_t index = std::min(values.size() - 1, (size_t)(q * (values.size() - 1) + 0.5));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    static double maximum(const std::vector<double>& values) {
+        return values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+    }
+
+    void trackSequence(long long seq, SeqTracker& tracker) {
+        if (seq < 0)
+            return;
+        if (tracker.expected < 0) {
+            tracker.expected = seq + 1;
+            return;
+        }
+        if (seq >= tracker.expected) {
+            // 跳过的序号计为丢失并在窗口中标记为缺失；窗口内被覆盖的槽位对应已移出窗口的旧序号
+            lostCount += seq - tracker.expected;
+            for (long long s = std::max(tracker.expected, seq - SEQ_WINDOW + 1); s <= seq; s++)
+                tracker.missing[s % SEQ_WINDOW] = s != seq;
+            tracker.expected = seq + 1;
+        }
+        else if (seq >= tracker.expected - SEQ_WINDOW && tracker.missing[seq % SEQ_WINDOW]) {
+            // 迟到的样本填补了此前计为丢失的序号，这里扣回
+            tracker.missing[seq % SEQ_WINDOW] = false;
+            reorderedCount++;
+            lostCount--;
+        }
+        else
+            duplicateCount++;
+    }
+
+    // 排空一个 socket，返回处理的数据报数
+    long drain(SilUdpLink& link, bool fromLocal, bool measuring) {
+        long count = 0;
+        long length;
+        while ((length = link.receive(buffer.data(), buffer.size())) >= 0) {
+            long long receivedNs = silMonotonicNs();
+            count++;
+            SvSample sample = decodeSvPayload(std::string(buffer.data(), strnlen(buffer.data(), length)));
+            if (std::isnan(sample.current)) {
+                malformedCount++;
+                continue;
+            }
+            if (fromLocal) {
+                localRxCount++;
+                trackSequence(sample.seq, seqLocal);
+            }
+            else {
+                remoteRxCount++;
+                trackSequence(sample.seq, seqRemote);
+            }
+            auto decision = engine.process(fromLocal, sample.current, sample.slot);
+            long long doneNs = silMonotonicNs();
+            if (decision.trip)
+                tripCount++;
+            if (!measuring)
+                continue;
+
+            double processing = doneNs - receivedNs;
+            processingNs.push_back(processing);
+            processingLatencyVec.record(processing * 1e-9);
+            processingLatencyHist.collect(processing * 1e-9);
+            if (sample.txNs >= 0) {
+                double endToEnd = doneNs - sample.txNs;
+                endToEndNs.push_back(endToEnd);
+                endToEndLatencyVec.record(endToEnd * 1e-9);
+                endToEndLatencyHist.collect(endToEnd * 1e-9);
+                if (endToEnd > deadlineNs)
+                    missedDeadlineCount++;
+                // 动作时延：触发判决的（后到一侧）样本从发送到判决完成的时间
+                if (decision.trip)
+                    tripLatencyNs.push_back(endToEnd);
+            }
+        }
+        return count;
+    }
+
+  protected:
+    virtual void initialize() override {
+        if (dynamic_cast<cRealTimeScheduler *>(getSimulation()->getScheduler()) == nullptr)
+            throw cRuntimeError("SilProtectionApp requires scheduler-class = \"omnetpp::cRealTimeScheduler\"");
+        engine.configure(par("threshold"), par("strictSlotMatch"), par("maxSlotLag"));
+        pollInterval = par("pollInterval");
+        warmupTime = par("warmupTime");
+        deadlineNs = (long long)(par("deadline").doubleValue() * 1e9);
+        buffer.resize(65536);
+
+        std::string bindAddress = par("bindAddress").stdstringValue();
+        int receiveBuffer = par("receiveBuffer");
+        socketLocal.open(bindAddress, par("localPort"));
+        socketLocal.setReceiveBuffer(receiveBuffer);
+        socketRemote.open(bindAddress, par("remotePort"));
+        socketRemote.setReceiveBuffer(receiveBuffer);
+
+        processingLatencyVec.setName("processingLatency");
+        endToEndLatencyVec.setName("endToEndLatency");
+        pollLatenessVec.setName("pollLateness");
+        processingLatencyHist.setName("processingLatency");
+        endToEndLatencyHist.setName("endToEndLatency");
+        pollLatenessHist.setName("pollLateness");
+
+        pollTimer = new cMessage("pollTimer");
+        scheduleAt(simTime() + pollInterval, pollTimer);
+    }
+
+    virtual void handleMessage(cMessage *msg) override {
+        if (msg != pollTimer) {
+            delete msg;
+            return;
+        }
+        bool measuring = simTime() >= warmupTime;
+        long long latenessNs = wallClock.lateness(simTime());
+        if (measuring) {
+            pollCount++;
+            pollLatenessNs.push_back(latenessNs);
+            pollLatenessVec.record(latenessNs * 1e-9);
+            pollLatenessHist.collect(latenessNs * 1e-9);
+        }
+        long batch = drain(socketLocal, true, measuring) + drain(socketRemote, false, measuring);
+        if (measuring && batch > maxBatch)
+            maxBatch = batch;
+        scheduleAt(simTime() + pollInterval, pollTimer);
+    }
+
+    virtual void finish() override {
+        cancelAndDelete(pollTimer);
+        pollTimer = nullptr;
+        socketLocal.close();
+        socketRemote.close();
+
+        long measured = endToEndNs.size();
+        double missedRatio = measured > 0 ? (double)missedDeadlineCount / measured : 0.0;
+        double processingP50 = percentile(processingNs, 0.50);
+        double processingP99 = percentile(processingNs, 0.99);
+        double processingMax = maximum(processingNs);
+        double endToEndP50 = percentile(endToEndNs, 0.50);
+        double endToEndP99 = percentile(endToEndNs, 0.99);
+        double endToEndMax = maximum(endToEndNs);
+        double latenessP50 = percentile(pollLatenessNs, 0.50);
+        double latenessP99 = percentile(pollLatenessNs, 0.99);
+        double latenessMax = maximum(pollLatenessNs);
+        double tripLatencyMax = maximum(tripLatencyNs);
+
+        // Cmdenv 快速模式不输出 EV 日志，结果直接写到标准输出（单位 us）
+        std::cout << "SilKPI: module=" << getFullPath()
+                  << ", rx_local=" << localRxCount
+                  << ", rx_remote=" << remoteRxCount
+                  << ", lost=" << lostCount
+                  << ", reordered=" << reorderedCount
+                  << ", duplicates=" << duplicateCount
+                  << ", malformed=" << malformedCount
+                  << ", matched=" << engine.getMatchedCount()
+                  << ", trips=" << tripCount
+                  << ", proc_p50_us=" << processingP50 / 1e3
+                  << ", proc_p99_us=" << processingP99 / 1e3
+                  << ", proc_max_us=" << processingMax / 1e3
+                  << ", e2e_p50_us=" << endToEndP50 / 1e3
+                  << ", e2e_p99_us=" << endToEndP99 / 1e3
+                  << ", e2e_max_us=" << endToEndMax / 1e3
+                  << ", poll_lateness_p50_us=" << latenessP50 / 1e3
+                  << ", poll_lateness_p99_us=" << latenessP99 / 1e3
+                  << ", poll_lateness_max_us=" << latenessMax / 1e3
+                  << ", deadline_us=" << deadlineNs / 1e3
+                  << ", missed_deadlines=" << missedDeadlineCount
+                  << ", missed_ratio=" << missedRatio
+                  << ", max_batch=" << maxBatch
+                  << std::endl;
+
+        recordScalar("localRxCount", localRxCount);
+        recordScalar("remoteRxCount", remoteRxCount);
+        recordScalar("totalRxCount", localRxCount + remoteRxCount);
+        recordScalar("lostCount", lostCount);
+        recordScalar("reorderedCount", reorderedCount);
+        recordScalar("duplicateCount", duplicateCount);
+        recordScalar("malformedCount", malformedCount);
+        recordScalar("matchedSvCount", engine.getMatchedCount());
+        recordScalar("overThresholdCount", engine.getOverThresholdCount());
+        recordScalar("tripCount", tripCount);
+        recordScalar("pollCount", pollCount);
+        recordScalar("maxBatch", maxBatch);
+        recordScalar("missedDeadlineCount", missedDeadlineCount);
+        recordScalar("missedDeadlineRatio", missedRatio);
+        recordScalar("processingLatencyP50", processingP50 * 1e-9, "s");
+        recordScalar("processingLatencyP99", processingP99 * 1e-9, "s");
+        recordScalar("processingLatencyMax", processingMax * 1e-9, "s");
+        recordScalar("endToEndLatencyP50", endToEndP50 * 1e-9, "s");
+        recordScalar("endToEndLatencyP99", endToEndP99 * 1e-9, "s");
+        recordScalar("endToEndLatencyMax", endToEndMax * 1e-9, "s");
+        recordScalar("pollLatenessP50", latenessP50 * 1e-9, "s");
+        recordScalar("pollLatenessP99", latenessP99 * 1e-9, "s");
+        recordScalar("pollLatenessMax", latenessMax * 1e-9, "s");
+        recordScalar("tripLatencyMax", tripLatencyMax * 1e-9, "s");
+        recordStatistic(&processingLatencyHist, "s");
+        recordStatistic(&endToEndLatencyHist, "s");
+        recordStatistic(&pollLatenessHist, "s");
+    }
+};
+
+Define_Module(SilProtectionApp);
@@ -0,0 +1,130 @@
+#ifndef __SMARTSUBSTATION_SILUDPLINK_H
+#define __SMARTSUBSTATION_SILUDPLINK_H
+
+#include <omnetpp.h>
+#include <chrono>
+#include <string>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// 单调时钟纳秒：同一主机上各进程共享（Linux CLOCK_MONOTONIC），SV 负载中的 txns 与接收端时间戳可直接相减
+inline long long silMonotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 仿真时间 -> 墙钟的对齐：以首个事件为锚点，事件的调度滞后 = 实际墙钟 - 该事件应在的墙钟时刻。
+// cRealTimeScheduler 按同样的线性关系把事件时间映射到墙钟，因此该滞后即调度器投递事件的迟到量。
+class SilWallClock
+{
+  private:
+    bool anchored = false;
+    long long anchorWallNs = 0;
+    omnetpp::simtime_t anchorSimTime;
+
+  public:
+    // 返回当前事件的调度滞后（纳秒，首次调用建立锚点并返回 0）
+    long long lateness(omnetpp::simtime_t now) {
+        long long wallNs = silMonotonicNs();
+        if (!anchored) {
+            anchored = true;
+            anchorWallNs = wallNs;
+            anchorSimTime = now;
+            return 0;
+        }
+        long long dueNs = anchorWallNs + (long long)((now - anchorSimTime).dbl() * 1e9);
+        return wallNs - dueNs;
+    }
+};
+
+// 软件在环用的最小 UDP 封装：IPv4 回环/本机地址，接收端非阻塞（由定时轮询排空）
+// 目前只实现 POSIX socket；Windows 下构造即报错
+class SilUdpLink
+{
+  private:
+#ifndef _WIN32
+    int fd = -1;
+#endif
+
+  public:
+    SilUdpLink() {}
+    SilUdpLink(const SilUdpLink&) = delete;
+    SilUdpLink& operator=(const SilUdpLink&) = delete;
+    ~SilUdpLink() { close(); }
+
+    // 打开 socket；bindPort >= 0 时绑定到 bindAddress:bindPort 并设为非阻塞
+    void open(const std::string& bindAddress, int bindPort) {
+#ifdef _WIN32
+        throw omnetpp::cRuntimeError("SilUdpLink: software-in-the-loop UDP is only supported on POSIX platforms");
+#else
+        fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0)
+            throw omnetpp::cRuntimeError("SilUdpLink: socket() failed: %s", strerror(errno));
+        if (bindPort >= 0) {
+            int reuse = 1;
+            ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in addr = makeAddress(bindAddress, bindPort);
+            if (::bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0)
+                throw omnetpp::cRuntimeError("SilUdpLink: bind(%s:%d) failed: %s", bindAddress.c_str(), bindPort, strerror(errno));
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        }
+#endif
+    }
+
+    // 放大接收缓冲区，避免轮询间隙内到达的 SV 在内核中被丢弃
+    void setReceiveBuffer(int bytes) {
+#ifndef _WIN32
+        if (fd >= 0 && bytes > 0)
+            ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes));
+#endif
+    }
+
+    bool sendTo(const std::string& address, int port, const char *data, size_t length) {
+#ifdef _WIN32
+        return false;
+#else
+        sockaddr_in addr = makeAddress(address, port);
+        return ::sendto(fd, data, length, 0, (sockaddr *)&addr, sizeof(addr)) == (ssize_t)length;
+#endif
+    }
+
+    // 非阻塞接收一个数据报；无数据时返回 -1
+    long receive(char *buffer, size_t capacity) {
+#ifdef _WIN32
+        return -1;
+#else
+        ssize_t n = ::recv(fd, buffer, capacity, 0);
+        return n >= 0 ? (long)n : -1;
+#endif
+    }
+
+    void close() {
+#ifndef _WIN32
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+    }
+
+#ifndef _WIN32
+  private:
+    static sockaddr_in makeAddress(const std::string& address, int port) {
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        if (::inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+            throw omnetpp::cRuntimeError("SilUdpLink: invalid IPv4 address '%s'", address.c_str());
+        return addr;
+    }
+#endif
+};
+
+#endif
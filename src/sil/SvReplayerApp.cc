@@ -0,0 +1,86 @@
+#include <omnetpp.h>
+#include <string>
+#include "../apps/SvSampleGenerator.h"
+#include "SilUdpLink.h"
+
+using namespace omnetpp;
+
+// SvReplayerApp：
+//  - 软件在环（SIL）模式下的 SV 发送端：与 SvGeneratorApp 共用 SvSampleGenerator 生成采样值，
+//    但不经过 INET，而是用真实 UDP socket 发往 destAddress:destPort（默认本机回环）；
+//  - 须在 cRealTimeScheduler 下运行，发送定时器按墙钟推进，4kHz（250us）或 14.4kHz（1s/14400）；
+//  - 负载在 SvGeneratorApp 的字段之后追加 txns（发送时刻，单调时钟纳秒），供接收端计算端到端时延；
+//  - 记录每次发送事件相对计划时刻的滞后（sendLateness），反映调度器/操作系统的定时精度。
+class SvReplayerApp : public cSimpleModule
+{
+  private:
+    SvSampleGenerator generator;
+    SilUdpLink link;
+    SilWallClock wallClock;
+    cMessage *timer = nullptr;
+    std::string destAddress;
+    int destPort = -1;
+    int msgLenBytes = 0;
+    int sourceId = -1;
+    long txCount = 0;
+    long sendFailures = 0;
+
+    cOutVector sendLatenessVec;
+    cHistogram sendLatenessHist;
+    long long maxLatenessNs = 0;
+
+  protected:
+    virtual void initialize() override {
+        if (dynamic_cast<cRealTimeScheduler *>(getSimulation()->getScheduler()) == nullptr)
+            throw cRuntimeError("SvReplayerApp requires scheduler-class = \"omnetpp::cRealTimeScheduler\"");
+        generator.configure(this);
+        destAddress = par("destAddress").stdstringValue();
+        destPort = par("destPort");
+        msgLenBytes = par("messageLength");
+        sourceId = par("sourceId");
+        link.open(destAddress, -1);
+        sendLatenessVec.setName("sendLateness");
+        sendLatenessHist.setName("sendLateness");
+        timer = new cMessage("sendTimer");
+        scheduleAt(simTime() + par("startDelay").doubleValue() + generator.getInterval(), timer);
+    }
+
+    virtual void handleMessage(cMessage *msg) override {
+        if (msg != timer) {
+            delete msg;
+            return;
+        }
+        long long latenessNs = wallClock.lateness(simTime());
+        sendLatenessVec.record(latenessNs * 1e-9);
+        sendLatenessHist.collect(latenessNs * 1e-9);
+        if (latenessNs > maxLatenessNs)
+            maxLatenessNs = latenessNs;
+
+        SvSample sample = generator.next(simTime());
+        sample.src = sourceId;
+        sample.txNs = silMonotonicNs();
+        std::string payload = encodeSvPayload(sample);
+        // 若配置的报文长度更大，则以 0 字节补齐，保持与仿真相同的报文规模
+        if ((int)payload.size() < msgLenBytes)
+            payload.resize(msgLenBytes, '\0');
+        if (link.sendTo(destAddress, destPort, payload.data(), payload.size()))
+            txCount++;
+        else
+            sendFailures++;
+        scheduleAt(simTime() + generator.getInterval(), timer);
+    }
+
+    virtual void finish() override {
+        cancelAndDelete(timer);
+        timer = nullptr;
+        link.close();
+        EV_INFO << getFullPath() << ": sent SV datagrams=" << txCount << ", sendFailures=" << sendFailures
+                << ", maxSendLatenessUs=" << maxLatenessNs / 1e3 << endl;
+        recordScalar("svTxCount", txCount);
+        recordScalar("sendFailures", sendFailures);
+        recordScalar("maxSendLateness", maxLatenessNs * 1e-9, "s");
+        recordStatistic(&sendLatenessHist, "s");
+    }
+};
+
+Define_Module(SvReplayerApp);
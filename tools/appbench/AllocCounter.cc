@@ -0,0 +1,37 @@
+//
+// AllocCounter：仅链接进微基准可执行文件（见 makefrag 的 bench 目标），统计全局 operator new 调用次数。
+// Linux 下可执行文件中的替换对 INET/OMNeT++ 共享库同样生效；Windows DLL 不受替换影响，只统计本工程代码的分配。
+//
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "src/bench/BenchAllocCounter.h"
+
+static std::atomic<unsigned long long> allocationCount(0);
+
+static unsigned long long currentAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+namespace {
+struct AllocCounterRegistrar {
+    AllocCounterRegistrar() { benchAllocationCounter = &currentAllocationCount; }
+} registrar;
+}
+
+void *operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size != 0 ? size : 1);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t&) noexcept { std::free(p); }
@@ -0,0 +1,104 @@
+//
+// PrpDiscardTableTest：src/apps/PrpDiscardTable.h 的独立测试，不依赖 OMNeT++/INET 运行库。
+// 覆盖：重复副本、窗口外旧序号、seq % windowSize 槽位回绕、丢失计数、多源隔离。
+// 任一断言失败时打印位置并返回非 0，供 make check 判定。
+//
+#include <cstdio>
+#include "PrpDiscardTable.h"
+
+static int failures = 0;
+
+#define EXPECT_EQ(actual, expected) \
+    do { \
+        long long a_ = (long long)(actual), e_ = (long long)(expected); \
+        if (a_ != e_) { \
+            std::fprintf(stderr, "%s:%d: %s = %lld, expected %lld\n", __FILE__, __LINE__, #actual, a_, e_); \
+            failures++; \
+        } \
+    } while (0)
+
+// LAN A/B 各送达一份：先到的接收，后到的判为重复
+static void testDuplicate() {
+    PrpDiscardTable table(8);
+    EXPECT_EQ(table.check(1, 0), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.check(1, 0), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.check(1, 1), PrpDiscardTable::ACCEPTED);
+    // LAN B 落后：副本在后续序号之后才到达
+    EXPECT_EQ(table.check(1, 2), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.check(1, 1), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.check(1, 2), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.getLostCount(), 0);
+}
+
+// 序号 <= maxSeq - windowSize 时槽位已被覆盖，无法判定，按窗口外丢弃
+static void testOutOfWindow() {
+    PrpDiscardTable table(8);
+    for (long long seq = 0; seq <= 10; seq++)
+        EXPECT_EQ(table.check(1, seq), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.check(1, 2), PrpDiscardTable::OUT_OF_WINDOW);
+    EXPECT_EQ(table.check(1, 0), PrpDiscardTable::OUT_OF_WINDOW);
+    // 下沿之内仍按槽位判定
+    EXPECT_EQ(table.check(1, 3), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.getLostCount(), 0);
+}
+
+// seq 与 seq + windowSize 映射到同一槽位：新序号覆盖旧槽位，不能被误判为重复
+static void testWraparound() {
+    PrpDiscardTable table(4);
+    for (long long seq = 0; seq < 4; seq++)
+        EXPECT_EQ(table.check(1, seq), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.check(1, 4), PrpDiscardTable::ACCEPTED);   // 覆盖槽位 0
+    EXPECT_EQ(table.check(1, 4), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.check(1, 0), PrpDiscardTable::OUT_OF_WINDOW);
+    EXPECT_EQ(table.check(1, 9), PrpDiscardTable::ACCEPTED);   // 跳过 5..8，槽位 1 由 1 变为 9
+    EXPECT_EQ(table.check(1, 9), PrpDiscardTable::DUPLICATE);
+    // 6 仍在窗口内，其槽位 2 中是旧序号 2，应作为首次到达接收
+    EXPECT_EQ(table.check(1, 6), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.check(1, 6), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.check(1, 5), PrpDiscardTable::OUT_OF_WINDOW);
+    EXPECT_EQ(table.getLostCount(), 3);   // 5、7、8 两条 LAN 都未送达
+}
+
+// 丢失数 = 各源已见序号区间长度 - 接收数；重复与窗口外报文不影响
+static void testLostCount() {
+    PrpDiscardTable table(16);
+    EXPECT_EQ(table.getLostCount(), 0);
+    const long long seqs[] = {10, 11, 13, 13, 17, 12};
+    for (long long seq : seqs)
+        table.check(1, seq);
+    EXPECT_EQ(table.getLostCount(), 3);   // 区间 10..17 共 8 个，接收 10/11/12/13/17
+    // 比首个序号更早的报文扩展区间下沿
+    EXPECT_EQ(table.check(1, 8), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.getLostCount(), 4);   // 再缺 9
+    // 另一源独立统计
+    EXPECT_EQ(table.check(2, 100), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.check(2, 100), PrpDiscardTable::DUPLICATE);
+    EXPECT_EQ(table.check(2, 102), PrpDiscardTable::ACCEPTED);
+    EXPECT_EQ(table.getNumSources(), 2);
+    EXPECT_EQ(table.getLostCount(), 5);
+}
+
+// setWindowSize 清空已有窗口
+static void testSetWindowSize() {
+    PrpDiscardTable table(8);
+    table.check(1, 5);
+    table.check(1, 7);
+    table.setWindowSize(4);
+    EXPECT_EQ(table.getNumSources(), 0);
+    EXPECT_EQ(table.getLostCount(), 0);
+    EXPECT_EQ(table.check(1, 5), PrpDiscardTable::ACCEPTED);
+}
+
+int main() {
+    testDuplicate();
+    testOutOfWindow();
+    testWraparound();
+    testLostCount();
+    testSetWindowSize();
+    if (failures > 0) {
+        std::fprintf(stderr, "PrpDiscardTableTest: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("PrpDiscardTableTest: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,953 @@
+//
+// resultanalyzer：OMNeT++ .sca/.vec 结果文件的命令行并行分析器
+//
+// 作用：
+//  - 替代 IDE 中 General.anf / GCLDiff-*.anf / SVOnly.anf 的单线程后处理，适合参数扫描产生的多 GB 结果；
+//  - 以内存映射方式读取 .sca/.vec（存在 .vci 索引时按索引块只读取相关向量），按 CPU 核数并行解析；
+//  - 按模块路径规则把应用模块归到业务类型（SV、GOOSE、VoIP、Video、OM_Data），计算与
+//    TrafficKpiReporter 同口径的 KPI：发送/接收数、PDR、平均时延、时延分位数、平均/最大抖动；
+//  - 按 configname 汇总多次运行，并输出两个配置（默认 GCLDiff-True 与 GCLDiff-False）的对比表；
+//    两个配置中 runnumber 相同的运行视为一对（demo.ini 中使用公共随机数），同时给出配对差分的 95% 置信区间。
+//
+// 用法：
+//  resultanalyzer [-j N] [--compare CFG_A CFG_B] [--flow GLOB=FLOW]... [--runs] [--csv] <文件或目录>...
+//    -j N              解析线程数（默认硬件线程数）
+//    --compare A B     输出配置 A 与 B 的 KPI 对比（默认在两者都存在时对比 GCLDiff-True 与 GCLDiff-False）
+//    --flow GLOB=FLOW  追加模块归类规则（优先于内置规则），例如 --flow "*.Protection_A.app[0]=SV"
+//    --runs            额外输出逐运行 KPI
+//    --csv             以 CSV 输出（便于脚本处理）
+//  目录参数会展开为其中的全部 .sca/.vec 文件（不递归）。
+//
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+// ==================== 内存映射只读文件 ====================
+class MappedFile
+{
+  private:
+    const char *data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = nullptr;
+#endif
+
+  public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+            return false;
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(fileHandle, &fileSize))
+            return false;
+        size = (size_t)fileSize.QuadPart;
+        if (size == 0)
+            return true;
+        mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mappingHandle == nullptr)
+            return false;
+        data = (const char *)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        return data != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size = (size_t)st.st_size;
+        if (size > 0) {
+            void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                return false;
+            }
+            data = (const char *)p;
+        }
+        ::close(fd);
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data != nullptr)
+            UnmapViewOfFile(data);
+        if (mappingHandle != nullptr)
+            CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (data != nullptr)
+            munmap((void *)data, size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    const char *begin() const { return data; }
+    const char *end() const { return data + size; }
+    size_t getSize() const { return size; }
+};
+
+// ==================== 文本解析辅助 ====================
+
+// 解析十进制浮点数（含符号、小数、指数及 nan/inf），不要求以 NUL 结尾；失败返回 NAN
+static double parseDouble(const char *p, const char *end) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+    if (p < end && (*p == 'n' || *p == 'N'))
+        return NAN;
+    if (p < end && (*p == 'i' || *p == 'I'))
+        return negative ? -INFINITY : INFINITY;
+    unsigned long long mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool any = false;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, any = true) {
+        if (digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0)
+                digits++;
+        }
+        else
+            exponent++;
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, any = true) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0)
+                    digits++;
+                exponent--;
+            }
+        }
+    }
+    if (!any)
+        return NAN;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool expNegative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            expNegative = (*p++ == '-');
+        int e = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++)
+            e = e * 10 + (*p - '0');
+        exponent += expNegative ? -e : e;
+    }
+    double value = (double)mantissa;
+    if (exponent != 0)
+        value *= std::pow(10.0, exponent);
+    return negative ? -value : value;
+}
+
+// 按空白切分一行，支持双引号包裹的字段（含 \" 转义）
+static std::vector<std::string> tokenize(const char *p, const char *end) {
+    std::vector<std::string> tokens;
+    while (p < end) {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        if (p >= end)
+            break;
+        std::string token;
+        if (*p == '"') {
+            for (p++; p < end && *p != '"'; p++) {
+                if (*p == '\\' && p + 1 < end)
+                    p++;
+                token += *p;
+            }
+            p++;
+        }
+        else {
+            while (p < end && *p != ' ' && *p != '\t' && *p != '\r')
+                token += *p++;
+        }
+        tokens.push_back(token);
+    }
+    return tokens;
+}
+
+static bool startsWith(const char *p, const char *end, const char *prefix) {
+    size_t n = std::strlen(prefix);
+    return (size_t)(end - p) >= n && std::memcmp(p, prefix, n) == 0;
+}
+
+static const char *lineEnd(const char *p, const char *end) {
+    const char *nl = (const char *)std::memchr(p, '\n', end - p);
+    return nl != nullptr ? nl : end;
+}
+
+// 简单通配匹配：* 匹配任意字符序列，? 匹配单个字符，其余字符（含 [ ]）按字面匹配
+static bool globMatch(const char *pattern, const char *text) {
+    const char *starPattern = nullptr;
+    const char *starText = nullptr;
+    while (*text) {
+        if (*pattern == '*') {
+            starPattern = pattern++;
+            starText = text;
+        }
+        else if (*pattern == '?' || *pattern == *text) {
+            pattern++;
+            text++;
+        }
+        else if (starPattern != nullptr) {
+            pattern = starPattern + 1;
+            text = ++starText;
+        }
+        else
+            return false;
+    }
+    while (*pattern == '*')
+        pattern++;
+    return *pattern == 0;
+}
+
+// ==================== 业务归类与 KPI 口径 ====================
+
+struct FlowRule {
+    std::string pattern;
+    std::string flow;
+};
+
+// 与 demo.ini 的业务部署一致；先匹配先生效
+static std::vector<FlowRule> defaultFlowRules() {
+    return {
+        {"*.MU_*.app[*]", "SV"},
+        {"*.Protection_*.app[*]", "SV"},
+        {"*.BusProtection_*.app[*]", "SV"},
+        {"*.IT_*.app[*]", "GOOSE"},
+        {"*.VoIP*.app[*]", "VoIP"},
+        {"*.Camera*.app[*]", "Video"},
+        {"*.MonitoringCenter_*.app[0]", "Video"},
+        {"*.MonitoringCenter_*.app[1]", "OM_Data"},
+        {"*.MonitoringCenter_*.app[2]", "VoIP"},
+    };
+}
+
+static const std::vector<std::string> FLOW_ORDER = {"SV", "GOOSE", "VoIP", "Video", "OM_Data", "Other", "ALL"};
+
+// 发送/接收计数标量：INET 应用的 packetSent/packetReceived 统计，以及本项目 SV 应用记录的计数
+static const std::unordered_set<std::string> SENT_SCALARS = {"packetSent:count", "svTxCount"};
+static const std::unordered_set<std::string> RECEIVED_SCALARS = {"packetReceived:count", "totalRxCount"};
+// 逐包端到端时延向量：DifferentialProtectionApp 的 SV 时延与 INET 接收端的 endToEndDelay
+static const std::unordered_set<std::string> DELAY_VECTORS = {"svDelayLocal", "svDelayRemote", "endToEndDelay:vector"};
+
+// ==================== 运行结果 ====================
+
+// 一个时延样本：记录时刻与事件号用于把同一业务的多个向量合并成按接收顺序排列的样本流
+struct DelaySample {
+    long long event;   // 事件号（向量格式不含事件号时为 -1）
+    double time;
+    double value;
+
+    bool operator<(const DelaySample& other) const {
+        if (time != other.time)
+            return time < other.time;
+        return event < other.event;
+    }
+};
+
+struct FlowKpi {
+    double sent = 0;
+    double received = 0;
+    std::vector<double> delays;
+    double jitterSum = 0;
+    long jitterSamples = 0;
+    double maxJitter = 0;
+
+    void merge(const FlowKpi& other) {
+        sent += other.sent;
+        received += other.received;
+        delays.insert(delays.end(), other.delays.begin(), other.delays.end());
+        jitterSum += other.jitterSum;
+        jitterSamples += other.jitterSamples;
+        maxJitter = std::max(maxJitter, other.maxJitter);
+    }
+
+    // 与 TrafficKpiReporter 相同：抖动按业务计算，为该业务所有接收样本（跨模块、跨向量）
+    // 按接收时刻排序后相邻两包时延差的绝对值；stream 须已按 DelaySample::operator< 排好序
+    void addDelayStream(const std::vector<DelaySample>& stream) {
+        delays.reserve(delays.size() + stream.size());
+        for (const auto& sample : stream)
+            delays.push_back(sample.value);
+        for (size_t i = 1; i < stream.size(); i++) {
+            double jitter = std::fabs(stream[i].value - stream[i - 1].value);
+            jitterSum += jitter;
+            jitterSamples++;
+            maxJitter = std::max(maxJitter, jitter);
+        }
+    }
+};
+
+struct RunResult {
+    std::string runId;
+    std::string config;
+    std::string runNumber;   // 配对键：两个配置中 runnumber 相同的运行使用相同种子
+    std::map<std::string, FlowKpi> flows;
+};
+
+struct KpiRow {
+    double sent = 0, received = 0, pdr = NAN;
+    double avgDelayMs = NAN, p50Ms = NAN, p95Ms = NAN, p99Ms = NAN, maxDelayMs = NAN;
+    double avgJitterMs = NAN, maxJitterMs = NAN;
+    size_t samples = 0;
+};
+
+static double percentile(std::vector<double>& sorted, double q) {
+    if (sorted.empty())
+        return NAN;
+    double rank = q * (sorted.size() - 1);
+    size_t lo = (size_t)rank;
+    size_t hi = std::min(lo + 1, sorted.size() - 1);
+    return sorted[lo] + (sorted[hi] - sorted[lo]) * (rank - lo);
+}
+
+static KpiRow computeKpi(const FlowKpi& kpi) {
+    KpiRow row;
+    row.sent = kpi.sent;
+    row.received = kpi.received;
+    if (kpi.sent > 0)
+        row.pdr = 100.0 * kpi.received / kpi.sent;
+    row.samples = kpi.delays.size();
+    if (!kpi.delays.empty()) {
+        std::vector<double> sorted = kpi.delays;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0;
+        for (double d : sorted)
+            sum += d;
+        row.avgDelayMs = 1000.0 * sum / sorted.size();
+        row.p50Ms = 1000.0 * percentile(sorted, 0.50);
+        row.p95Ms = 1000.0 * percentile(sorted, 0.95);
+        row.p99Ms = 1000.0 * percentile(sorted, 0.99);
+        row.maxDelayMs = 1000.0 * sorted.back();
+    }
+    if (kpi.jitterSamples > 0) {
+        row.avgJitterMs = 1000.0 * kpi.jitterSum / kpi.jitterSamples;
+        row.maxJitterMs = 1000.0 * kpi.maxJitter;
+    }
+    return row;
+}
+
+// ==================== 并行任务执行 ====================
+
+static void runParallel(size_t numTasks, int numThreads, const std::function<void(size_t)>& task) {
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    int n = (int)std::min<size_t>(numThreads, numTasks);
+    for (int i = 0; i < n; i++) {
+        workers.emplace_back([&] () {
+            for (size_t k = next++; k < numTasks; k = next++)
+                task(k);
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+}
+
+// ==================== 分析器 ====================
+
+class ResultAnalyzer
+{
+  private:
+    struct VectorDecl {
+        std::string module;
+        std::string name;
+        std::string flow;
+    };
+
+    // 一个 .vec 文件中的一段字节区间（来自 .vci 索引块，或无索引时的按行对齐分块）
+    struct VecTask {
+        size_t fileIndex;
+        size_t begin;
+        size_t end;
+        // 解析结果：向量 id -> 按文件顺序的样本
+        std::unordered_map<int, std::vector<DelaySample>> values;
+    };
+
+    struct VecFile {
+        std::string path;
+        MappedFile file;
+        std::string runId;
+        std::string config;
+        std::string runNumber;
+        std::unordered_map<int, VectorDecl> decls;   // 仅保留需要的时延向量
+    };
+
+    std::vector<FlowRule> rules;
+    int numThreads;
+    std::map<std::string, RunResult> runs;   // runId -> 结果
+    std::mutex runsMutex;
+
+    std::string classify(const std::string& module) const {
+        for (const auto& rule : rules)
+            if (globMatch(rule.pattern.c_str(), module.c_str()))
+                return rule.flow;
+        return "Other";
+    }
+
+    RunResult& runFor(const std::string& runId) {
+        auto& run = runs[runId];
+        run.runId = runId;
+        return run;
+    }
+
+    // 解析文件头中的 run / attr configname / attr runnumber（缺省时退回 repetition）
+    static void parseRunHeader(const char *p, const char *end, std::string& runId, std::string& config, std::string& runNumber) {
+        if (startsWith(p, end, "run ")) {
+            auto tokens = tokenize(p, end);
+            if (tokens.size() >= 2)
+                runId = tokens[1];
+        }
+        else if (startsWith(p, end, "attr ")) {
+            auto tokens = tokenize(p, end);
+            if (tokens.size() >= 3 && tokens[1] == "configname")
+                config = tokens[2];
+            else if (tokens.size() >= 3 && tokens[1] == "runnumber")
+                runNumber = tokens[2];
+            else if (tokens.size() >= 3 && tokens[1] == "repetition" && runNumber.empty())
+                runNumber = tokens[2];
+        }
+    }
+
+    void analyzeScalarFile(const std::string& path) {
+        MappedFile file;
+        if (!file.open(path)) {
+            std::fprintf(stderr, "warning: cannot open %s\n", path.c_str());
+            return;
+        }
+        std::string runId, config, runNumber;
+        std::map<std::string, FlowKpi> flows;
+        for (const char *p = file.begin(); p < file.end(); ) {
+            const char *e = lineEnd(p, file.end());
+            if (startsWith(p, e, "scalar ")) {
+                auto tokens = tokenize(p, e);
+                if (tokens.size() >= 4) {
+                    bool isSent = SENT_SCALARS.count(tokens[2]) != 0;
+                    bool isReceived = RECEIVED_SCALARS.count(tokens[2]) != 0;
+                    if (isSent || isReceived) {
+                        double value = parseDouble(tokens[3].data(), tokens[3].data() + tokens[3].size());
+                        if (!std::isnan(value)) {
+                            auto& kpi = flows[classify(tokens[1])];
+                            (isSent ? kpi.sent : kpi.received) += value;
+                        }
+                    }
+                }
+            }
+            else
+                parseRunHeader(p, e, runId, config, runNumber);
+            p = e + 1;
+        }
+        if (runId.empty())
+            runId = path;
+
+        std::lock_guard<std::mutex> lock(runsMutex);
+        auto& run = runFor(runId);
+        run.config = config;
+        run.runNumber = runNumber;
+        for (auto& item : flows) {
+            run.flows[item.first].sent += item.second.sent;
+            run.flows[item.first].received += item.second.received;
+        }
+    }
+
+    // 处理一行向量声明，只保留需要的时延向量
+    void handleVectorDecl(VecFile& vec, const char *p, const char *e) {
+        auto tokens = tokenize(p, e);
+        if (tokens.size() < 4 || DELAY_VECTORS.count(tokens[3]) == 0)
+            return;
+        VectorDecl decl;
+        decl.module = tokens[2];
+        decl.name = tokens[3];
+        decl.flow = classify(decl.module);
+        vec.decls[std::atoi(tokens[1].c_str())] = decl;
+    }
+
+    // 读取 .vci 索引：向量声明与数据块位置；只为需要的向量生成任务
+    bool loadIndex(VecFile& vec, size_t fileIndex, std::vector<std::unique_ptr<VecTask>>& tasks) {
+        MappedFile index;
+        std::string indexPath = vec.path.substr(0, vec.path.size() - 4) + ".vci";
+        if (!fs::exists(indexPath) || !index.open(indexPath))
+            return false;
+        std::vector<std::unique_ptr<VecTask>> indexTasks;
+        for (const char *p = index.begin(); p < index.end(); ) {
+            const char *e = lineEnd(p, index.end());
+            if (startsWith(p, e, "vector "))
+                handleVectorDecl(vec, p, e);
+            else if (p < e && *p >= '0' && *p <= '9') {
+                // <id> <offset> <length> ...
+                char *q;
+                long id = std::strtol(p, &q, 10);
+                unsigned long long offset = std::strtoull(q, &q, 10);
+                unsigned long long length = std::strtoull(q, &q, 10);
+                if (vec.decls.count((int)id) != 0 && offset + length <= vec.file.getSize()) {
+                    auto task = std::make_unique<VecTask>();
+                    task->fileIndex = fileIndex;
+                    task->begin = offset;
+                    task->end = offset + length;
+                    indexTasks.push_back(std::move(task));
+                }
+            }
+            else
+                parseRunHeader(p, e, vec.runId, vec.config, vec.runNumber);
+            p = e + 1;
+        }
+        for (auto& task : indexTasks)
+            tasks.push_back(std::move(task));
+        return true;
+    }
+
+    // 无索引时按行对齐切块：每块处理起始位置落在 [begin, end) 内的行
+    void splitIntoChunks(VecFile& vec, size_t fileIndex, std::vector<std::unique_ptr<VecTask>>& tasks) {
+        const size_t chunkSize = 16 << 20;
+        for (size_t begin = 0; begin < vec.file.getSize(); begin += chunkSize) {
+            auto task = std::make_unique<VecTask>();
+            task->fileIndex = fileIndex;
+            task->begin = begin;
+            task->end = std::min(begin + chunkSize, vec.file.getSize());
+            tasks.push_back(std::move(task));
+        }
+    }
+
+    // 无索引时的声明预扫描：各块并行查找 "vector " 与文件头行，跳过数据行
+    void scanDeclarations(std::vector<std::unique_ptr<VecFile>>& vecFiles, std::vector<std::unique_ptr<VecTask>>& tasks, const std::vector<bool>& indexed) {
+        std::mutex declMutex;
+        runParallel(tasks.size(), numThreads, [&] (size_t k) {
+            auto& task = *tasks[k];
+            auto& vec = *vecFiles[task.fileIndex];
+            if (indexed[task.fileIndex])
+                return;
+            const char *base = vec.file.begin();
+            const char *p = base + task.begin;
+            if (task.begin > 0 && p[-1] != '\n')
+                p = lineEnd(p, vec.file.end()) + 1;
+            const char *stop = base + task.end;
+            while (p < stop) {
+                const char *e = lineEnd(p, vec.file.end());
+                if (!(*p >= '0' && *p <= '9')) {
+                    std::lock_guard<std::mutex> lock(declMutex);
+                    if (startsWith(p, e, "vector "))
+                        handleVectorDecl(vec, p, e);
+                    else
+                        parseRunHeader(p, e, vec.runId, vec.config, vec.runNumber);
+                }
+                p = e + 1;
+            }
+        });
+    }
+
+    // 解析数据行 "<id> [event] <time> <value>"：值取最后一列，时刻取倒数第二列，有四列时第二列为事件号
+    static void parseVectorData(VecTask& task, const VecFile& vec) {
+        const char *base = vec.file.begin();
+        const char *fileEnd = vec.file.end();
+        const char *p = base + task.begin;
+        if (task.begin > 0 && p[-1] != '\n')
+            p = lineEnd(p, fileEnd) + 1;
+        const char *stop = base + task.end;
+        while (p < stop) {
+            const char *e = lineEnd(p, fileEnd);
+            if (*p >= '0' && *p <= '9') {
+                int id = 0;
+                const char *q = p;
+                for (; q < e && *q >= '0' && *q <= '9'; q++)
+                    id = id * 10 + (*q - '0');
+                if (vec.decls.count(id) != 0) {
+                    // 最多取 id 之后的 3 列
+                    const char *fieldBegin[3], *fieldEnd[3];
+                    int numFields = 0;
+                    const char *r = q;
+                    while (numFields < 3) {
+                        while (r < e && (*r == ' ' || *r == '\t' || *r == '\r'))
+                            r++;
+                        if (r >= e)
+                            break;
+                        fieldBegin[numFields] = r;
+                        while (r < e && *r != ' ' && *r != '\t' && *r != '\r')
+                            r++;
+                        fieldEnd[numFields++] = r;
+                    }
+                    if (numFields >= 2) {
+                        DelaySample sample;
+                        sample.value = parseDouble(fieldBegin[numFields - 1], fieldEnd[numFields - 1]);
+                        sample.time = parseDouble(fieldBegin[numFields - 2], fieldEnd[numFields - 2]);
+                        sample.event = numFields == 3 ? std::strtoll(fieldBegin[0], nullptr, 10) : -1;
+                        if (!std::isnan(sample.value) && !std::isnan(sample.time))
+                            task.values[id].push_back(sample);
+                    }
+                }
+            }
+            p = e + 1;
+        }
+    }
+
+    void analyzeVectorFiles(const std::vector<std::string>& paths) {
+        std::vector<std::unique_ptr<VecFile>> vecFiles;
+        std::vector<std::unique_ptr<VecTask>> tasks;
+        std::vector<bool> indexed;
+        for (const auto& path : paths) {
+            auto vec = std::make_unique<VecFile>();
+            vec->path = path;
+            if (!vec->file.open(path)) {
+                std::fprintf(stderr, "warning: cannot open %s\n", path.c_str());
+                continue;
+            }
+            size_t fileIndex = vecFiles.size();
+            bool hasIndex = loadIndex(*vec, fileIndex, tasks);
+            if (!hasIndex)
+                splitIntoChunks(*vec, fileIndex, tasks);
+            indexed.push_back(hasIndex);
+            vecFiles.push_back(std::move(vec));
+        }
+
+        scanDeclarations(vecFiles, tasks, indexed);
+        runParallel(tasks.size(), numThreads, [&] (size_t k) {
+            parseVectorData(*tasks[k], *vecFiles[tasks[k]->fileIndex]);
+        });
+
+        // 同一运行同一业务的所有时延向量合并为一个样本流，按接收时刻（同一时刻再按事件号）排序后计算抖动
+        std::map<std::string, std::map<std::string, std::vector<DelaySample>>> streams;
+        for (auto& task : tasks) {
+            auto& vec = *vecFiles[task->fileIndex];
+            std::string runId = vec.runId.empty() ? vec.path : vec.runId;
+            for (auto& item : task->values) {
+                auto& target = streams[runId][vec.decls[item.first].flow];
+                target.insert(target.end(), item.second.begin(), item.second.end());
+            }
+            task->values.clear();
+        }
+        for (auto& vecPtr : vecFiles) {
+            auto& vec = *vecPtr;
+            auto& run = runFor(vec.runId.empty() ? vec.path : vec.runId);
+            if (run.config.empty()) {
+                run.config = vec.config;
+                run.runNumber = vec.runNumber;
+            }
+        }
+        for (auto& runItem : streams) {
+            auto& run = runFor(runItem.first);
+            for (auto& flowItem : runItem.second) {
+                std::stable_sort(flowItem.second.begin(), flowItem.second.end());
+                run.flows[flowItem.first].addDelayStream(flowItem.second);
+            }
+        }
+    }
+
+  public:
+    ResultAnalyzer(const std::vector<FlowRule>& rules, int numThreads) : rules(rules), numThreads(numThreads) {}
+
+    void analyze(const std::vector<std::string>& scaFiles, const std::vector<std::string>& vecFiles) {
+        runParallel(scaFiles.size(), numThreads, [&] (size_t k) { analyzeScalarFile(scaFiles[k]); });
+        analyzeVectorFiles(vecFiles);
+        // ALL 为各业务合计
+        for (auto& item : runs) {
+            FlowKpi all;
+            for (const auto& flow : item.second.flows)
+                if (flow.first != "ALL")
+                    all.merge(flow.second);
+            item.second.flows["ALL"] = std::move(all);
+        }
+    }
+
+    const std::map<std::string, RunResult>& getRuns() const { return runs; }
+
+    // 同一配置下所有运行的合并 KPI
+    std::map<std::string, FlowKpi> pooled(const std::string& config, int& numRuns) const {
+        std::map<std::string, FlowKpi> result;
+        numRuns = 0;
+        for (const auto& item : runs) {
+            if (item.second.config != config)
+                continue;
+            numRuns++;
+            for (const auto& flow : item.second.flows)
+                result[flow.first].merge(flow.second);
+        }
+        return result;
+    }
+
+    std::set<std::string> getConfigs() const {
+        std::set<std::string> configs;
+        for (const auto& item : runs)
+            configs.insert(item.second.config);
+        return configs;
+    }
+};
+
+// ==================== 输出 ====================
+
+static std::string fmt(double value) {
+    if (std::isnan(value))
+        return "-";
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.4f", value);
+    return buf;
+}
+
+static std::string fmtCount(double value) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.0f", value);
+    return buf;
+}
+
+static void printKpiTable(const std::string& title, const std::map<std::string, FlowKpi>& flows, bool csv) {
+    if (csv)
+        std::printf("# %s\nflow,sent,recv,pdr_pct,samples,avg_delay_ms,p50_ms,p95_ms,p99_ms,max_delay_ms,avg_jitter_ms,max_jitter_ms\n", title.c_str());
+    else
+        std::printf("\n== %s ==\n%-8s %10s %10s %8s %9s %12s %9s %9s %9s %9s %13s %13s\n", title.c_str(),
+                    "flow", "sent", "recv", "pdr_pct", "samples", "avg_delay_ms", "p50_ms", "p95_ms", "p99_ms", "max_ms", "avg_jitter_ms", "max_jitter_ms");
+    for (const auto& flow : FLOW_ORDER) {
+        auto it = flows.find(flow);
+        if (it == flows.end())
+            continue;
+        KpiRow row = computeKpi(it->second);
+        if (row.sent == 0 && row.received == 0 && row.samples == 0)
+            continue;
+        const char *format = csv ? "%s,%s,%s,%s,%zu,%s,%s,%s,%s,%s,%s,%s\n"
+                                 : "%-8s %10s %10s %8s %9zu %12s %9s %9s %9s %9s %13s %13s\n";
+        std::printf(format, flow.c_str(), fmtCount(row.sent).c_str(), fmtCount(row.received).c_str(), fmt(row.pdr).c_str(),
+                    row.samples, fmt(row.avgDelayMs).c_str(), fmt(row.p50Ms).c_str(), fmt(row.p95Ms).c_str(), fmt(row.p99Ms).c_str(),
+                    fmt(row.maxDelayMs).c_str(), fmt(row.avgJitterMs).c_str(), fmt(row.maxJitterMs).c_str());
+    }
+}
+
+// 双侧 95% t 分位数，df = 1..30；更大自由度取正态近似
+static double tQuantile975(int df) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (df < 1)
+        return NAN;
+    return df <= 30 ? table[df - 1] : 1.960;
+}
+
+// 配对差分：同一 runnumber（即相同种子与随机数流映射）的 A/B 运行逐对相减，
+// 公共随机数下两者的随机波动大部分相互抵消，置信区间明显窄于两组独立样本
+struct PairedDiff {
+    int pairs = 0;
+    double mean = NAN;
+    double halfWidth = NAN;
+};
+
+static PairedDiff pairedDifference(const std::vector<std::pair<double, double>>& samples) {
+    PairedDiff result;
+    std::vector<double> diffs;
+    for (const auto& sample : samples)
+        if (!std::isnan(sample.first) && !std::isnan(sample.second))
+            diffs.push_back(sample.first - sample.second);
+    result.pairs = (int)diffs.size();
+    if (diffs.empty())
+        return result;
+    double sum = 0;
+    for (double d : diffs)
+        sum += d;
+    result.mean = sum / diffs.size();
+    if (diffs.size() >= 2) {
+        double sq = 0;
+        for (double d : diffs)
+            sq += (d - result.mean) * (d - result.mean);
+        double stddev = std::sqrt(sq / (diffs.size() - 1));
+        result.halfWidth = tQuantile975((int)diffs.size() - 1) * stddev / std::sqrt((double)diffs.size());
+    }
+    return result;
+}
+
+static void printComparison(const ResultAnalyzer& analyzer, const std::string& configA, const std::string& configB, bool csv) {
+    int runsA = 0, runsB = 0;
+    auto flowsA = analyzer.pooled(configA, runsA);
+    auto flowsB = analyzer.pooled(configB, runsB);
+
+    // 按 runnumber 配对两个配置的逐运行 KPI
+    std::map<std::string, const RunResult *> byNumberA, byNumberB;
+    for (const auto& item : analyzer.getRuns()) {
+        if (item.second.config == configA)
+            byNumberA[item.second.runNumber] = &item.second;
+        else if (item.second.config == configB)
+            byNumberB[item.second.runNumber] = &item.second;
+    }
+    std::vector<std::pair<const RunResult *, const RunResult *>> pairs;
+    for (const auto& item : byNumberA) {
+        auto it = byNumberB.find(item.first);
+        if (it != byNumberB.end())
+            pairs.push_back({item.second, it->second});
+    }
+
+    struct Metric {
+        const char *name;
+        double KpiRow::*field;
+    };
+    const Metric metrics[] = {
+        {"pdr_pct", &KpiRow::pdr}, {"avg_delay_ms", &KpiRow::avgDelayMs}, {"p95_ms", &KpiRow::p95Ms},
+        {"p99_ms", &KpiRow::p99Ms}, {"max_delay_ms", &KpiRow::maxDelayMs}, {"avg_jitter_ms", &KpiRow::avgJitterMs},
+        {"max_jitter_ms", &KpiRow::maxJitterMs},
+    };
+    if (csv)
+        std::printf("# compare %s (runs=%d) vs %s (runs=%d), paired=%zu\nflow,metric,%s,%s,delta,pairs,paired_mean_diff,ci95_low,ci95_high\n",
+                    configA.c_str(), runsA, configB.c_str(), runsB, pairs.size(), configA.c_str(), configB.c_str());
+    else
+        std::printf("\n== Compare %s (runs=%d) vs %s (runs=%d), paired=%zu ==\n%-8s %-14s %14s %14s %12s %6s %12s %12s %12s\n",
+                    configA.c_str(), runsA, configB.c_str(), runsB, pairs.size(),
+                    "flow", "metric", configA.c_str(), configB.c_str(), "delta", "pairs", "paired_diff", "ci95_low", "ci95_high");
+    for (const auto& flow : FLOW_ORDER) {
+        auto itA = flowsA.find(flow);
+        auto itB = flowsB.find(flow);
+        if (itA == flowsA.end() && itB == flowsB.end())
+            continue;
+        KpiRow rowA = itA != flowsA.end() ? computeKpi(itA->second) : KpiRow();
+        KpiRow rowB = itB != flowsB.end() ? computeKpi(itB->second) : KpiRow();
+        std::vector<std::pair<KpiRow, KpiRow>> pairRows;
+        for (const auto& pair : pairs) {
+            auto runA = pair.first->flows.find(flow);
+            auto runB = pair.second->flows.find(flow);
+            pairRows.push_back({runA != pair.first->flows.end() ? computeKpi(runA->second) : KpiRow(),
+                                runB != pair.second->flows.end() ? computeKpi(runB->second) : KpiRow()});
+        }
+        for (const auto& metric : metrics) {
+            double a = rowA.*metric.field;
+            double b = rowB.*metric.field;
+            if (std::isnan(a) && std::isnan(b))
+                continue;
+            std::vector<std::pair<double, double>> samples;
+            for (const auto& pairRow : pairRows)
+                samples.push_back({pairRow.first.*metric.field, pairRow.second.*metric.field});
+            PairedDiff diff = pairedDifference(samples);
+            // 少于 2 对时 t 区间无定义，输出 "-" 而不是零宽区间
+            double ciLow = diff.pairs >= 2 ? diff.mean - diff.halfWidth : NAN;
+            double ciHigh = diff.pairs >= 2 ? diff.mean + diff.halfWidth : NAN;
+            const char *format = csv ? "%s,%s,%s,%s,%s,%d,%s,%s,%s\n" : "%-8s %-14s %14s %14s %12s %6d %12s %12s %12s\n";
+            std::printf(format, flow.c_str(), metric.name, fmt(a).c_str(), fmt(b).c_str(), fmt(a - b).c_str(), diff.pairs,
+                        fmt(diff.mean).c_str(), fmt(ciLow).c_str(), fmt(ciHigh).c_str());
+        }
+    }
+}
+
+static void usage() {
+    std::fprintf(stderr,
+                 "usage: resultanalyzer [-j N] [--compare CFG_A CFG_B] [--flow GLOB=FLOW]... [--runs] [--csv] <file|dir>...\n");
+}
+
+int main(int argc, char **argv) {
+    int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<FlowRule> rules;
+    std::string compareA, compareB;
+    bool perRun = false;
+    bool csv = false;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+            numThreads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--compare" && i + 2 < argc) {
+            compareA = argv[++i];
+            compareB = argv[++i];
+        }
+        else if (arg == "--flow" && i + 1 < argc) {
+            std::string rule = argv[++i];
+            size_t eq = rule.rfind('=');
+            if (eq == std::string::npos) {
+                usage();
+                return 1;
+            }
+            rules.push_back({rule.substr(0, eq), rule.substr(eq + 1)});
+        }
+        else if (arg == "--runs")
+            perRun = true;
+        else if (arg == "--csv")
+            csv = true;
+        else if (arg == "-h" || arg == "--help") {
+            usage();
+            return 0;
+        }
+        else
+            inputs.push_back(arg);
+    }
+    if (inputs.empty()) {
+        usage();
+        return 1;
+    }
+    for (const auto& rule : defaultFlowRules())
+        rules.push_back(rule);
+
+    std::vector<std::string> scaFiles, vecFiles;
+    for (const auto& input : inputs) {
+        std::vector<fs::path> candidates;
+        if (fs::is_directory(input)) {
+            for (const auto& entry : fs::directory_iterator(input))
+                candidates.push_back(entry.path());
+            std::sort(candidates.begin(), candidates.end());
+        }
+        else
+            candidates.push_back(input);
+        for (const auto& path : candidates) {
+            if (path.extension() == ".sca")
+                scaFiles.push_back(path.string());
+            else if (path.extension() == ".vec")
+                vecFiles.push_back(path.string());
+        }
+    }
+    if (scaFiles.empty() && vecFiles.empty()) {
+        std::fprintf(stderr, "no .sca/.vec files found\n");
+        return 1;
+    }
+
+    ResultAnalyzer analyzer(rules, numThreads);
+    analyzer.analyze(scaFiles, vecFiles);
+
+    if (perRun) {
+        for (const auto& item : analyzer.getRuns())
+            printKpiTable("Run " + item.first + " (" + item.second.config + ")", item.second.flows, csv);
+    }
+    for (const auto& config : analyzer.getConfigs()) {
+        int numRuns = 0;
+        auto flows = analyzer.pooled(config, numRuns);
+        printKpiTable("Config " + config + " (runs=" + std::to_string(numRuns) + ")", flows, csv);
+    }
+
+    auto configs = analyzer.getConfigs();
+    if (compareA.empty() && configs.count("GCLDiff-True") && configs.count("GCLDiff-False")) {
+        compareA = "GCLDiff-True";
+        compareB = "GCLDiff-False";
+    }
+    if (!compareA.empty())
+        printComparison(analyzer, compareA, compareB, csv);
+    return 0;
+}